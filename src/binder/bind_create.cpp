@@ -20,6 +20,7 @@
 // THE SOFTWARE.
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <string>
@@ -133,7 +134,28 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // There is no INCLUDE clause in the grammar, so included columns are given as an option:
+  // `CREATE INDEX ... WITH (include = 'col, ...')`.
+  std::vector<std::unique_ptr<BoundColumnRef>> included_cols;
+  if (stmt->options != nullptr) {
+    for (auto cell = stmt->options->head; cell != nullptr; cell = cell->next) {
+      auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg);
+      if (strcmp(option->defname, "include") != 0) {
+        throw NotImplementedException(fmt::format("index option {} is not supported", option->defname));
+      }
+      if (value == nullptr || value->type != duckdb_libpgquery::T_PGString) {
+        throw bustub::Exception("include takes a string of comma separated column names");
+      }
+      for (const auto &name : StringUtil::Split(value->val.str, ',')) {
+        auto column_ref = ResolveColumn(*table, std::vector{StringUtil::Strip(name, ' ')});
+        included_cols.emplace_back(std::make_unique<BoundColumnRef>(dynamic_cast<const BoundColumnRef &>(*column_ref)));
+      }
+    }
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), stmt->unique,
+                                          std::move(included_cols));
 }
 
 }  // namespace bustub
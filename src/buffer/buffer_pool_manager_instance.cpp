@@ -12,6 +12,9 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <cstring>
+#include <memory>
+
 #include "common/exception.h"
 #include "common/macros.h"
 
@@ -19,11 +22,28 @@ namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
                                                      LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(instance_index),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_];
   page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
   replacer_ = new LRUKReplacer(pool_size, replacer_k);
+  disk_scheduler_ = new DiskScheduler(disk_manager);
+  io_in_progress_.resize(pool_size_, false);
+  rec_lsn_.resize(pool_size_, INVALID_LSN);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -32,67 +52,163 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopPageCleaner();
+  delete disk_scheduler_;
   delete[] pages_;
   delete page_table_;
   delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_id = -1;
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id, bool scan_only)
+    -> bool {
+  *victim_page_id = INVALID_PAGE_ID;
   if (!free_list_.empty()) {
-    frame_id = free_list_.front();
+    *frame_id = free_list_.front();
     free_list_.pop_front();
-  } else if (replacer_->Evict(&frame_id)) {
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-    }
-    page_table_->Remove(pages_[frame_id].GetPageId());
-  } else {
-    page_id = nullptr;
+    return true;
+  }
+  if (!replacer_->Evict(frame_id, scan_only)) {
+    return false;
+  }
+  Page &victim = pages_[*frame_id];
+  page_table_->Remove(victim.GetPageId());
+  if (victim.IsDirty()) {
+    // Until the write-back completes, a fetch of the victim must not read the stale copy on disk.
+    *victim_page_id = victim.GetPageId();
+    evicting_pages_.emplace(*victim_page_id, rec_lsn_[*frame_id]);
+    // The page cleaner is falling behind.
+    cleaner_cv_.notify_one();
+  }
+  rec_lsn_[*frame_id] = INVALID_LSN;
+  return true;
+}
+
+auto BufferPoolManagerInstance::ScheduleIo(bool is_write, char *data, page_id_t page_id) -> std::future<bool> {
+  if (is_write) {
+    FlushLogForPage(data);
+  }
+  auto promise = disk_scheduler_->CreatePromise();
+  auto future = promise.get_future();
+  disk_scheduler_->Schedule({is_write, data, page_id, std::move(promise)});
+  return future;
+}
+
+void BufferPoolManagerInstance::FlushLogForPage(const char *data) {
+  if (log_manager_ == nullptr || !enable_logging) {
+    return;
+  }
+  lsn_t lsn;
+  memcpy(&lsn, data + Page::OFFSET_LSN, sizeof(lsn_t));
+  if (lsn > log_manager_->GetPersistentLSN()) {
+    log_manager_->Flush(lsn);
+  }
+}
+
+void BufferPoolManagerInstance::FinishWriteBack(page_id_t victim_page_id) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    evicting_pages_.erase(victim_page_id);
+  }
+  io_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FinishFrameIo(frame_id_t frame_id) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    io_in_progress_[frame_id] = false;
+  }
+  io_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FinishPrefetch(frame_id_t frame_id) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    io_in_progress_[frame_id] = false;
+    replacer_->SetEvictable(frame_id, true);
+  }
+  io_cv_.notify_all();
+}
+
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id = -1;
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&frame_id, &victim_page_id)) {
     return nullptr;
   }
+  Page &page = pages_[frame_id];
   *page_id = AllocatePage();
   page_table_->Insert(*page_id, frame_id);
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = *page_id;
-  pages_[frame_id].pin_count_ = 1;
-  pages_[frame_id].is_dirty_ = false;
+  page.page_id_ = *page_id;
+  page.pin_count_ = 1;
+  page.is_dirty_ = false;
+  TrackRecLSN(frame_id);
+  io_in_progress_[frame_id] = true;
   replacer_->RecordAccess(frame_id);
   replacer_->SetEvictable(frame_id, false);
-  return &pages_[frame_id];
+  lock.unlock();
+
+  if (victim_page_id != INVALID_PAGE_ID) {
+    ScheduleIo(true, page.GetData(), victim_page_id).wait();
+    FinishWriteBack(victim_page_id);
+  }
+  page.ResetMemory();
+  FinishFrameIo(frame_id);
+  return &page;
 }
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
   assert(page_id != INVALID_PAGE_ID);
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id = -1;
-  if (page_table_->Find(page_id, frame_id)) {
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
-    pages_[frame_id].pin_count_++;
-    return &pages_[frame_id];
-  }
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Evict(&frame_id)) {
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
+  // If another thread is reading this page in, or is still writing it back after evicting it, wait for that
+  // I/O to finish instead of issuing a second one.
+  while (true) {
+    if (page_table_->Find(page_id, frame_id)) {
+      if (!io_in_progress_[frame_id]) {
+        replacer_->RecordAccess(frame_id, access_type);
+        replacer_->SetEvictable(frame_id, false);
+        pages_[frame_id].pin_count_++;
+        TrackRecLSN(frame_id);
+        return &pages_[frame_id];
+      }
+    } else if (evicting_pages_.count(page_id) == 0) {
+      break;
     }
-    page_table_->Remove(pages_[frame_id].GetPageId());
-  } else {
+    io_cv_.wait(lock);
+  }
+
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&frame_id, &victim_page_id)) {
     return nullptr;
   }
+  Page &page = pages_[frame_id];
   page_table_->Insert(page_id, frame_id);
-  pages_[frame_id].ResetMemory();
-  pages_[frame_id].page_id_ = page_id;
-  pages_[frame_id].pin_count_ = 1;
-  pages_[frame_id].is_dirty_ = false;
-  disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
-  replacer_->RecordAccess(frame_id);
+  page.page_id_ = page_id;
+  page.pin_count_ = 1;
+  page.is_dirty_ = false;
+  TrackRecLSN(frame_id);
+  io_in_progress_[frame_id] = true;
+  replacer_->RecordAccess(frame_id, access_type);
   replacer_->SetEvictable(frame_id, false);
-  return &pages_[frame_id];
+  lock.unlock();
+
+  if (victim_page_id != INVALID_PAGE_ID) {
+    // Write the victim out of a private copy so that the read into the frame can proceed at the same time.
+    std::unique_ptr<char[]> victim_data(new char[bustub_page_size]);
+    memcpy(victim_data.get(), page.GetData(), bustub_page_size);
+    page.ResetMemory();
+    auto write_done = ScheduleIo(true, victim_data.get(), victim_page_id);
+    auto read_done = ScheduleIo(false, page.GetData(), page_id);
+    write_done.wait();
+    FinishWriteBack(victim_page_id);
+    read_done.wait();
+  } else {
+    page.ResetMemory();
+    ScheduleIo(false, page.GetData(), page_id).wait();
+  }
+  FinishFrameIo(frame_id);
+  return &page;
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
@@ -105,51 +221,247 @@ auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) ->
   pages_[frame_id].is_dirty_ |= is_dirty;
   if (pages_[frame_id].GetPinCount() == 0) {
     replacer_->SetEvictable(frame_id, true);
+    ReleaseRecLSN(frame_id);
   }
   return true;
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id;
-  if (!page_table_->Find(page_id, frame_id)) {
-    return false;
+  while (true) {
+    if (!page_table_->Find(page_id, frame_id)) {
+      return false;
+    }
+    if (!io_in_progress_[frame_id]) {
+      break;
+    }
+    io_cv_.wait(lock);
   }
-  disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-  pages_->is_dirty_ = false;
+  // Pin the frame for the duration of the write so that it cannot be evicted under us.
+  PinForWriteBack(frame_id);
+  lock.unlock();
+
+  WriteBackFrames({frame_id});
+
+  lock.lock();
+  UnpinAfterWriteBack({frame_id});
   return true;
 }
+
 void BufferPoolManagerInstance::FlushAllPgsImp() {
+  std::unique_lock<std::mutex> lock(latch_);
+  // Pages that are being read in or written back right now have nothing newer to flush.
+  std::vector<frame_id_t> frames;
   frame_id_t tmp;
-  std::scoped_lock<std::mutex> lock(latch_);
   for (size_t frame_id = 0; frame_id < pool_size_; frame_id++) {
-    if (page_table_->Find(pages_[frame_id].GetPageId(), tmp)) {
-      disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-      pages_->is_dirty_ = false;
+    if (!io_in_progress_[frame_id] && page_table_->Find(pages_[frame_id].GetPageId(), tmp)) {
+      PinForWriteBack(frame_id);
+      frames.push_back(frame_id);
     }
   }
+  lock.unlock();
+
+  WriteBackFrames(frames);
+
+  lock.lock();
+  UnpinAfterWriteBack(frames);
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::unique_lock<std::mutex> lock(latch_);
   DeallocatePage(page_id);
   frame_id_t frame_id;
-  if (!page_table_->Find(page_id, frame_id)) {
-    return true;
+  while (true) {
+    if (!page_table_->Find(page_id, frame_id)) {
+      return true;
+    }
+    // An unpinned frame can only be doing I/O because the page is being read ahead.
+    if (!io_in_progress_[frame_id]) {
+      break;
+    }
+    io_cv_.wait(lock);
   }
   if (pages_[frame_id].GetPinCount() > 0) {
     return false;
   }
-  if (pages_[frame_id].IsDirty()) {
-    disk_manager_->WritePage(pages_[frame_id].GetPageId(), pages_[frame_id].GetData());
-    pages_->is_dirty_ = false;
-  }
+  Page &page = pages_[frame_id];
   replacer_->Remove(frame_id);
-  free_list_.push_back(frame_id);
   page_table_->Remove(page_id);
+  if (page.IsDirty()) {
+    // The frame only goes back to the free list once the write-back is done.
+    evicting_pages_.emplace(page_id, rec_lsn_[frame_id]);
+    lock.unlock();
+    ScheduleIo(true, page.GetData(), page_id).wait();
+    lock.lock();
+    evicting_pages_.erase(page_id);
+  }
+  // The frame keeps its old contents until it is reused, as callers may still peek at a page they just deleted.
+  page.is_dirty_ = false;
+  rec_lsn_[frame_id] = INVALID_LSN;
+  free_list_.push_back(frame_id);
+  lock.unlock();
+  io_cv_.notify_all();
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::PrefetchPage(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (page_table_->Find(page_id, frame_id) || evicting_pages_.count(page_id) > 0) {
+    return;
+  }
+  page_id_t victim_page_id;
+  if (!AcquireFrame(&frame_id, &victim_page_id, true)) {
+    return;
+  }
+  Page &page = pages_[frame_id];
+  std::shared_ptr<char[]> victim_data;
+  if (victim_page_id != INVALID_PAGE_ID) {
+    victim_data.reset(new char[bustub_page_size]);
+    memcpy(victim_data.get(), page.GetData(), bustub_page_size);
+  }
+  page_table_->Insert(page_id, frame_id);
+  page.page_id_ = page_id;
+  page.pin_count_ = 0;
+  page.is_dirty_ = false;
+  io_in_progress_[frame_id] = true;
+  // The frame stays out of the replacer until the read completes.
+  replacer_->RecordAccess(frame_id, AccessType::Scan);
+  lock.unlock();
+
+  // Nobody waits for these requests; their completion hooks finish the bookkeeping.
+  if (victim_page_id != INVALID_PAGE_ID) {
+    FlushLogForPage(victim_data.get());
+    disk_scheduler_->Schedule({true, victim_data.get(), victim_page_id, disk_scheduler_->CreatePromise(),
+                               [this, victim_page_id, victim_data] { FinishWriteBack(victim_page_id); }});
+  }
+  page.ResetMemory();
+  disk_scheduler_->Schedule(
+      {false, page.GetData(), page_id, disk_scheduler_->CreatePromise(), [this, frame_id] { FinishPrefetch(frame_id); }});
+}
+
+auto BufferPoolManagerInstance::GetDirtyPageTable() -> std::unordered_map<page_id_t, lsn_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::unordered_map<page_id_t, lsn_t> dirty_pages(evicting_pages_.begin(), evicting_pages_.end());
+  frame_id_t frame_id;
+  for (size_t i = 0; i < pool_size_; i++) {
+    page_id_t page_id = pages_[i].GetPageId();
+    if (rec_lsn_[i] != INVALID_LSN && page_table_->Find(page_id, frame_id) && frame_id == static_cast<frame_id_t>(i)) {
+      dirty_pages[page_id] = rec_lsn_[i];
+    }
+  }
+  return dirty_pages;
+}
+
+void BufferPoolManagerInstance::StartPageCleaner(size_t low_watermark, size_t high_watermark) {
+  BUSTUB_ASSERT(low_watermark <= high_watermark, "the low watermark cannot be above the high watermark");
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (cleaner_thread_ != nullptr) {
+    return;
+  }
+  cleaner_low_watermark_ = low_watermark;
+  cleaner_high_watermark_ = high_watermark;
+  cleaner_stop_ = false;
+  cleaner_thread_ = new std::thread([&] { RunPageCleaner(); });
+}
+
+void BufferPoolManagerInstance::StopPageCleaner() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (cleaner_thread_ == nullptr) {
+      return;
+    }
+    cleaner_stop_ = true;
+  }
+  cleaner_cv_.notify_one();
+  cleaner_thread_->join();
+  delete cleaner_thread_;
+  cleaner_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::RunPageCleaner() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!cleaner_stop_) {
+    cleaner_cv_.wait_for(lock, page_cleaner_interval);
+    if (cleaner_stop_) {
+      break;
+    }
+    auto frames = CollectFramesToClean();
+    if (frames.empty()) {
+      continue;
+    }
+    lock.unlock();
+    WriteBackFrames(frames);
+    lock.lock();
+    UnpinAfterWriteBack(frames);
+  }
+}
+
+auto BufferPoolManagerInstance::CollectFramesToClean() -> std::vector<frame_id_t> {
+  std::vector<frame_id_t> frames;
+  size_t clean = free_list_.size();
+  if (clean >= cleaner_low_watermark_) {
+    return frames;
+  }
+  // Only the frames that are about to be evicted matter; cleaning a hot page would just waste a write.
+  auto candidates = replacer_->EvictionCandidates(cleaner_high_watermark_ - clean);
+  for (frame_id_t frame_id : candidates) {
+    clean += pages_[frame_id].IsDirty() ? 0 : 1;
+  }
+  if (clean >= cleaner_low_watermark_) {
+    return frames;
+  }
+  // A page must not reach the disk before the log records that modified it (WAL).
+  bool check_lsn = log_manager_ != nullptr && enable_logging;
+  lsn_t persistent_lsn = check_lsn ? log_manager_->GetPersistentLSN() : INVALID_LSN;
+  for (frame_id_t frame_id : candidates) {
+    Page &page = pages_[frame_id];
+    if (!page.IsDirty() || (check_lsn && page.GetLSN() > persistent_lsn)) {
+      continue;
+    }
+    PinForWriteBack(frame_id);
+    frames.push_back(frame_id);
+  }
+  return frames;
+}
+
+void BufferPoolManagerInstance::PinForWriteBack(frame_id_t frame_id) {
+  Page &page = pages_[frame_id];
+  page.pin_count_++;
+  page.is_dirty_ = false;
+  replacer_->SetEvictable(frame_id, false);
+}
+
+void BufferPoolManagerInstance::WriteBackFrames(const std::vector<frame_id_t> &frames) {
+  // Issue every write before waiting on any of them.
+  std::vector<std::future<bool>> writes;
+  writes.reserve(frames.size());
+  for (frame_id_t frame_id : frames) {
+    writes.push_back(ScheduleIo(true, pages_[frame_id].GetData(), pages_[frame_id].GetPageId()));
+  }
+  for (auto &write : writes) {
+    write.wait();
+  }
+}
+
+void BufferPoolManagerInstance::UnpinAfterWriteBack(const std::vector<frame_id_t> &frames) {
+  for (frame_id_t frame_id : frames) {
+    if (--pages_[frame_id].pin_count_ == 0) {
+      replacer_->SetEvictable(frame_id, true);
+      ReleaseRecLSN(frame_id);
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::AllocatePage() -> page_id_t {
+  const page_id_t next_page_id = next_page_id_.fetch_add(num_instances_);
+  ValidatePageId(next_page_id);
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
+}
 
 }  // namespace bustub
@@ -12,75 +12,201 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames),
+      k_(k),
+      history_(num_frames * k),
+      history_head_(num_frames, 0),
+      history_size_(num_frames, 0),
+      evictable_(num_frames, false),
+      scan_only_(num_frames, false),
+      heap_pos_(num_frames, INVALID_HEAP_POS) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+  // Each frame sits in at most one heap, so neither heap ever grows past num_frames.
+  history_heap_.reserve(num_frames);
+  cache_heap_.reserve(num_frames);
+  scan_heap_.reserve(num_frames);
+}
 
-auto LRUKReplacer::Judge(frame_id_t s, frame_id_t t) -> bool {
-  if (hash_[s].time_.size() < k_ && hash_[t].time_.size() == k_) {
-    return true;
+auto LRUKReplacer::Evict(frame_id_t *frame_id, bool scan_only) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto *heap = &scan_heap_;
+  if (heap->empty() && !scan_only) {
+    heap = history_heap_.empty() ? &cache_heap_ : &history_heap_;
   }
-  if (hash_[s].time_.size() == k_ && hash_[t].time_.size() < k_) {
+  if (heap->empty()) {
+    *frame_id = -1;
     return false;
   }
-  return hash_[s].time_.front() < hash_[t].time_.front();
+  *frame_id = heap->front();
+  HeapErase(*heap, *frame_id);
+  ResetHistory(*frame_id);
+  evictable_[*frame_id] = false;
+  curr_size_--;
+  return true;
 }
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
   std::scoped_lock<std::mutex> lock(latch_);
-  *frame_id = -1;
-  for (const auto &kv : hash_) {
-    if (kv.second.evictable_) {
-      if (*frame_id == -1 || Judge(kv.first, *frame_id)) {
-        *frame_id = kv.first;
-      }
-    }
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  size_t &size = history_size_[frame_id];
+  const bool cold = size == 0 || scan_only_[frame_id];
+  if (access_type == AccessType::Scan && !cold) {
+    // A scan passing over a hot page neither promotes nor demotes it.
+    return;
   }
-  if (*frame_id != -1) {
-    hash_.erase(*frame_id);
-    curr_size_--;
-
-    return true;
+  const size_t timestamp = current_timestamp_++;
+  if (cold) {
+    // The frame starts over: as a member of the cold region on a scan, or as a regular frame otherwise.
+    if (evictable_[frame_id]) {
+      HeapErase(scan_heap_, frame_id);
+    }
+    ResetHistory(frame_id);
+    scan_only_[frame_id] = access_type == AccessType::Scan;
+    history_[frame_id * k_] = timestamp;
+    size = 1;
+    if (evictable_[frame_id]) {
+      HeapPush(HeapOf(frame_id), frame_id);
+    }
+    return;
   }
-  return false;
-}
-
-void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
-  std::scoped_lock<std::mutex> lock(latch_);
-  if (hash_.count(frame_id) == 0 && replacer_size_ == hash_.size()) {
+  if (size < k_) {
+    // The first access stays the oldest one, so the frame keeps its place until it reaches k accesses.
+    history_[frame_id * k_ + size] = timestamp;
+    if (++size == k_ && evictable_[frame_id]) {
+      HeapErase(history_heap_, frame_id);
+      HeapPush(cache_heap_, frame_id);
+    }
     return;
   }
-  if (hash_[frame_id].time_.size() == k_) {
-    hash_[frame_id].time_.pop();
+  // Overwrite the oldest slot; the k-th most recent access moves forward, so the frame can only sink.
+  size_t &head = history_head_[frame_id];
+  history_[frame_id * k_ + head] = timestamp;
+  head = (head + 1) % k_;
+  if (evictable_[frame_id]) {
+    SiftDown(cache_heap_, heap_pos_[frame_id]);
   }
-  hash_[frame_id].time_.push(current_timestamp_++);
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (hash_.count(frame_id) != 0) {
-    bool flag = hash_[frame_id].evictable_;
-    hash_[frame_id].evictable_ = set_evictable;
-    if (!flag && set_evictable) {
-      curr_size_++;
-    } else if (flag && !set_evictable) {
-      curr_size_--;
-    }
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (history_size_[frame_id] == 0 || evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  evictable_[frame_id] = set_evictable;
+  if (set_evictable) {
+    HeapPush(HeapOf(frame_id), frame_id);
+    curr_size_++;
+  } else {
+    HeapErase(HeapOf(frame_id), frame_id);
+    curr_size_--;
   }
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (hash_.count(frame_id) == 0) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "invalid frame id");
+  if (history_size_[frame_id] == 0) {
     return;
   }
-  if (!hash_[frame_id].evictable_) {
+  if (!evictable_[frame_id]) {
     throw "Remove a non-evictable frame!";
   }
-  hash_.erase(frame_id);
+  HeapErase(HeapOf(frame_id), frame_id);
+  ResetHistory(frame_id);
+  evictable_[frame_id] = false;
   curr_size_--;
 }
 
 auto LRUKReplacer::Size() -> size_t { return curr_size_; }
 
+auto LRUKReplacer::EvictionCandidates(size_t n) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  candidates.reserve(std::min(n, curr_size_));
+  HeapPeek(scan_heap_, n, &candidates);
+  HeapPeek(history_heap_, n, &candidates);
+  HeapPeek(cache_heap_, n, &candidates);
+  return candidates;
+}
+
+void LRUKReplacer::HeapPeek(const std::vector<frame_id_t> &heap, size_t n, std::vector<frame_id_t> *out) const {
+  // The children of a popped node are the only new candidates, so the frontier stays small.
+  using Entry = std::pair<size_t, size_t>;  // (earliest access, heap position)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> frontier;
+  if (!heap.empty()) {
+    frontier.emplace(EarliestAccess(heap[0]), 0);
+  }
+  while (!frontier.empty() && out->size() < n) {
+    size_t pos = frontier.top().second;
+    frontier.pop();
+    out->push_back(heap[pos]);
+    for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); child++) {
+      frontier.emplace(EarliestAccess(heap[child]), child);
+    }
+  }
+}
+
+void LRUKReplacer::HeapPush(std::vector<frame_id_t> &heap, frame_id_t frame_id) {
+  heap.push_back(frame_id);
+  heap_pos_[frame_id] = heap.size() - 1;
+  SiftUp(heap, heap.size() - 1);
+}
+
+void LRUKReplacer::HeapErase(std::vector<frame_id_t> &heap, frame_id_t frame_id) {
+  const size_t pos = heap_pos_[frame_id];
+  const frame_id_t last = heap.back();
+  heap.pop_back();
+  heap_pos_[frame_id] = INVALID_HEAP_POS;
+  if (last == frame_id) {
+    return;
+  }
+  // Move the last frame into the hole; it may need to go either way.
+  HeapPlace(heap, pos, last);
+  SiftUp(heap, pos);
+  SiftDown(heap, heap_pos_[last]);
+}
+
+void LRUKReplacer::SiftUp(std::vector<frame_id_t> &heap, size_t pos) {
+  const frame_id_t frame_id = heap[pos];
+  const size_t key = EarliestAccess(frame_id);
+  while (pos > 0) {
+    const size_t parent = (pos - 1) / 2;
+    if (EarliestAccess(heap[parent]) <= key) {
+      break;
+    }
+    HeapPlace(heap, pos, heap[parent]);
+    pos = parent;
+  }
+  HeapPlace(heap, pos, frame_id);
+}
+
+void LRUKReplacer::SiftDown(std::vector<frame_id_t> &heap, size_t pos) {
+  const frame_id_t frame_id = heap[pos];
+  const size_t key = EarliestAccess(frame_id);
+  while (true) {
+    size_t child = 2 * pos + 1;
+    if (child >= heap.size()) {
+      break;
+    }
+    if (child + 1 < heap.size() && EarliestAccess(heap[child + 1]) < EarliestAccess(heap[child])) {
+      child++;
+    }
+    if (key <= EarliestAccess(heap[child])) {
+      break;
+    }
+    HeapPlace(heap, pos, heap[child]);
+    pos = child;
+  }
+  HeapPlace(heap, pos, frame_id);
+}
+
 }  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager)
+    : num_instances_(num_instances), pool_size_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  instances_.reserve(num_instances_);
+  for (size_t i = 0; i < num_instances_; i++) {
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager));
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  return instances_[static_cast<size_t>(page_id) % num_instances_].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, access_type);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  const size_t start = next_instance_.fetch_add(1) % num_instances_;
+  for (size_t i = 0; i < num_instances_; i++) {
+    Page *page = instances_[(start + i) % num_instances_]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  for (auto &instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+void ParallelBufferPoolManager::StartPageCleaner(size_t low_watermark, size_t high_watermark) {
+  for (auto &instance : instances_) {
+    instance->StartPageCleaner(low_watermark, high_watermark);
+  }
+}
+
+void ParallelBufferPoolManager::StopPageCleaner() {
+  for (auto &instance : instances_) {
+    instance->StopPageCleaner();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPage(page_id_t page_id) { GetBufferPoolManager(page_id)->PrefetchPage(page_id); }
+
+auto ParallelBufferPoolManager::GetDirtyPageTable() -> std::unordered_map<page_id_t, lsn_t> {
+  std::unordered_map<page_id_t, lsn_t> dirty_pages;
+  for (auto &instance : instances_) {
+    dirty_pages.merge(instance->GetDirtyPageTable());
+  }
+  return dirty_pages;
+}
+
+}  // namespace bustub
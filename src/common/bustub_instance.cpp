@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cctype>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -12,6 +14,7 @@
 #include "binder/statement/select_statement.h"
 #include "binder/statement/set_show_statement.h"
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "catalog/table_generator.h"
 #include "common/bustub_instance.h"
@@ -40,11 +43,23 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_,
+                                           GetHashJoinMemoryBudget());
 }
 
-BustubInstance::BustubInstance(const std::string &db_file_name) {
+/** Set the process-wide page size. It has to happen before the disk manager and the buffer pool are created. */
+static void SetPageSize(int page_size) {
+  if (page_size < DEFAULT_BUSTUB_PAGE_SIZE || page_size > MAX_BUSTUB_PAGE_SIZE) {
+    throw Exception(fmt::format("page size must be between {} and {} bytes", DEFAULT_BUSTUB_PAGE_SIZE,
+                                MAX_BUSTUB_PAGE_SIZE));
+  }
+  bustub_page_size = page_size;
+}
+
+BustubInstance::BustubInstance(const std::string &db_file_name, size_t buffer_pool_instances, int page_size,
+                               size_t buffer_pool_size) {
   enable_logging = false;
+  SetPageSize(page_size);
 
   // Storage related.
   disk_manager_ = new DiskManager(db_file_name);
@@ -55,7 +70,15 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(BUFFER_POOL_SIZE, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (buffer_pool_instances > 1) {
+      buffer_pool_manager_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size, disk_manager_,
+                                                           LRUK_REPLACER_K, log_manager_);
+    } else {
+      buffer_pool_manager_ =
+          new BufferPoolManagerInstance(buffer_pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    }
+    buffer_pool_manager_->StartPageCleaner(buffer_pool_size * PAGE_CLEANER_LOW_WATERMARK / 100,
+                                           buffer_pool_size * PAGE_CLEANER_HIGH_WATERMARK / 100);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -75,8 +98,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   execution_engine_ = new ExecutionEngine(buffer_pool_manager_, txn_manager_, catalog_);
 }
 
-BustubInstance::BustubInstance() {
+BustubInstance::BustubInstance(size_t buffer_pool_instances, int page_size, size_t buffer_pool_size) {
   enable_logging = false;
+  SetPageSize(page_size);
 
   // Storage related.
   disk_manager_ = new DiskManagerUnlimitedMemory();
@@ -87,7 +111,15 @@ BustubInstance::BustubInstance() {
   // We need more frames for GenerateTestTable to work. Therefore, we use 128 instead of the default
   // buffer pool size specified in `config.h`.
   try {
-    buffer_pool_manager_ = new BufferPoolManagerInstance(128, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    if (buffer_pool_instances > 1) {
+      buffer_pool_manager_ = new ParallelBufferPoolManager(buffer_pool_instances, buffer_pool_size, disk_manager_,
+                                                           LRUK_REPLACER_K, log_manager_);
+    } else {
+      buffer_pool_manager_ =
+          new BufferPoolManagerInstance(buffer_pool_size, disk_manager_, LRUK_REPLACER_K, log_manager_);
+    }
+    buffer_pool_manager_->StartPageCleaner(buffer_pool_size * PAGE_CLEANER_LOW_WATERMARK / 100,
+                                           buffer_pool_size * PAGE_CLEANER_HIGH_WATERMARK / 100);
   } catch (NotImplementedException &e) {
     std::cerr << "BufferPoolManager is not implemented, only mock tables are supported." << std::endl;
     buffer_pool_manager_ = nullptr;
@@ -234,19 +266,30 @@ auto BustubInstance::ExecuteSqlTxn(
         for (const auto &col : index_stmt.cols_) {
           auto idx = index_stmt.table_->schema_.GetColIdx(col->col_name_.back());
           col_ids.push_back(idx);
-          if (index_stmt.table_->schema_.GetColumn(idx).GetType() != TypeId::INTEGER) {
-            throw NotImplementedException("only support creating index on integer column");
+          auto type = index_stmt.table_->schema_.GetColumn(idx).GetType();
+          if (type == TypeId::BOOLEAN || type == TypeId::TIMESTAMP) {
+            throw NotImplementedException(fmt::format("cannot create index on {} column", Type::TypeIdToString(type)));
           }
         }
-        if (col_ids.size() != 1) {
-          throw NotImplementedException("only support creating index with exactly one column");
-        }
         auto key_schema = Schema::CopySchema(&index_stmt.table_->schema_, col_ids);
 
+        std::vector<uint32_t> included_col_ids;
+        for (const auto &col : index_stmt.included_cols_) {
+          included_col_ids.push_back(index_stmt.table_->schema_.GetColIdx(col->col_name_.back()));
+        }
+        auto included_schema = Schema::CopySchema(&index_stmt.table_->schema_, included_col_ids);
+        if (!included_col_ids.empty() && (IsLossyIndexKey(key_schema) || IsLossyIndexKey(included_schema))) {
+          throw NotImplementedException("included columns need a key and included columns without VARCHAR");
+        }
+        auto key_size = BPlusTreeIndexKeySize(key_schema, index_stmt.unique_, included_schema.GetLength());
+
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
-            txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+        auto info = DispatchIndexKeySize(key_size, [&](auto key_size_constant) {
+          constexpr size_t KEY_SIZE = decltype(key_size_constant)::value;
+          return catalog_->CreateIndex<GenericKey<KEY_SIZE>, RID, GenericComparator<KEY_SIZE>>(
+              txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
+              KEY_SIZE, HashFunction<GenericKey<KEY_SIZE>>{}, index_stmt.unique_, included_col_ids);
+        });
         l.unlock();
 
         if (info == nullptr) {
@@ -263,6 +306,12 @@ auto BustubInstance::ExecuteSqlTxn(
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (set_stmt.variable_ == "hash_join_memory_budget" &&
+            (set_stmt.value_.empty() ||
+             !std::all_of(set_stmt.value_.begin(), set_stmt.value_.end(),
+                          [](unsigned char c) { return std::isdigit(c) != 0; }))) {
+          throw Exception("hash_join_memory_budget must be a number of bytes");
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
@@ -404,6 +453,9 @@ BustubInstance::~BustubInstance() {
   if (enable_logging) {
     log_manager_->StopFlushThread();
   }
+  if (buffer_pool_manager_ != nullptr) {
+    buffer_pool_manager_->StopPageCleaner();
+  }
   delete execution_engine_;
   delete catalog_;
   delete checkpoint_manager_;
@@ -33,9 +33,12 @@ auto TransactionManager::Begin(Transaction *txn, IsolationLevel isolation_level)
   }
 
   if (enable_logging) {
+    // A checkpoint must not see the BEGIN record's LSN handed out without the transaction being active.
+    std::scoped_lock<std::mutex> lock(active_txn_latch_);
     LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BEGIN);
     lsn_t lsn = log_manager_->AppendLogRecord(&record);
     txn->SetPrevLSN(lsn);
+    active_txn_[txn->GetTransactionId()] = lsn;
   }
 
   std::unique_lock<std::shared_mutex> l(txn_map_mutex);
@@ -59,6 +62,15 @@ void TransactionManager::Commit(Transaction *txn) {
   }
   write_set->clear();
 
+  if (enable_logging) {
+    LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::COMMIT);
+    lsn_t lsn = log_manager_->AppendLogRecord(&record);
+    txn->SetPrevLSN(lsn);
+    // The commit is durable once its record is; concurrent commits wait for the same log write (group commit).
+    log_manager_->Flush(lsn);
+  }
+  EndTransaction(txn);
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
@@ -91,8 +103,8 @@ void TransactionManager::Abort(Transaction *txn) {
     // Metadata identifying the table that should be deleted from.
     TableInfo *table_info = catalog->GetTable(item.table_oid_);
     IndexInfo *index_info = catalog->GetIndex(item.index_oid_);
-    auto new_key = item.tuple_.KeyFromTuple(table_info->schema_, *(index_info->index_->GetKeySchema()),
-                                            index_info->index_->GetKeyAttrs());
+    auto new_key = item.tuple_.KeyFromTuple(table_info->schema_, *(index_info->index_->GetStoredSchema()),
+                                            index_info->index_->GetStoredAttrs());
     if (item.wtype_ == WType::DELETE) {
       index_info->index_->InsertEntry(new_key, item.rid_, txn);
     } else if (item.wtype_ == WType::INSERT) {
@@ -100,8 +112,8 @@ void TransactionManager::Abort(Transaction *txn) {
     } else if (item.wtype_ == WType::UPDATE) {
       // Delete the new key and insert the old key
       index_info->index_->DeleteEntry(new_key, item.rid_, txn);
-      auto old_key = item.old_tuple_.KeyFromTuple(table_info->schema_, *(index_info->index_->GetKeySchema()),
-                                                  index_info->index_->GetKeyAttrs());
+      auto old_key = item.old_tuple_.KeyFromTuple(table_info->schema_, *(index_info->index_->GetStoredSchema()),
+                                                  index_info->index_->GetStoredAttrs());
       index_info->index_->InsertEntry(old_key, item.rid_, txn);
     }
     index_write_set->pop_back();
@@ -109,12 +121,29 @@ void TransactionManager::Abort(Transaction *txn) {
   table_write_set->clear();
   index_write_set->clear();
 
+  if (enable_logging) {
+    LogRecord record = LogRecord(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::ABORT);
+    lsn_t lsn = log_manager_->AppendLogRecord(&record);
+    txn->SetPrevLSN(lsn);
+  }
+  EndTransaction(txn);
+
   // Release all the locks.
   ReleaseLocks(txn);
   // Release the global transaction latch.
   global_txn_latch_.RUnlock();
 }
 
+auto TransactionManager::GetActiveTransactionTable() -> std::unordered_map<txn_id_t, lsn_t> {
+  std::scoped_lock<std::mutex> lock(active_txn_latch_);
+  return active_txn_;
+}
+
+void TransactionManager::EndTransaction(Transaction *txn) {
+  std::scoped_lock<std::mutex> lock(active_txn_latch_);
+  active_txn_.erase(txn->GetTransactionId());
+}
+
 void TransactionManager::BlockAllTransactions() { global_txn_latch_.WLock(); }
 
 void TransactionManager::ResumeTransactions() { global_txn_latch_.WUnlock(); }
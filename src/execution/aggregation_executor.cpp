@@ -26,18 +26,19 @@ AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const Aggreg
 
 void AggregationExecutor::Init(ProcessRecordContext *ptx) {
   child_->Init(ptx);
-  Tuple tuple;
-  RID rid;
-  while (child_->Next(&tuple, &rid, ptx)) {
-    auto aggregate_key = MakeAggregateKey(&tuple);
-    auto aggregate_value = MakeAggregateValue(&tuple);
-    aht_.InsertCombine(aggregate_key, aggregate_value);
+  TupleBatch batch;
+  while (child_->NextBatch(&batch, ptx)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      auto aggregate_key = MakeAggregateKey(&batch.GetTuple(i));
+      auto aggregate_value = MakeAggregateValue(&batch.GetTuple(i));
+      aht_.InsertCombine(aggregate_key, aggregate_value);
+    }
   }
   aht_iterator_ = aht_.Begin();  // 插入后需要重新指定 aht_iterator_
 }
 
 auto AggregationExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
-  Schema schema(plan_->OutputSchema());
+  const Schema &schema = plan_->OutputSchema();
   if (aht_iterator_ != aht_.End()) {
     std::vector<Value> value(aht_iterator_.Key().group_bys_);
     for (const auto &aggregate : aht_iterator_.Val().aggregates_) {
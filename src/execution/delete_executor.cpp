@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/delete_executor.h"
 
@@ -40,8 +42,16 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid, ProcessRecord
   if (successful_) {
     return false;
   }
-  int count = 0;
+  // Read all tuples to delete first. An index scan below keeps its current leaf latched, which removing their index
+  // entries would wait on.
+  std::vector<std::pair<Tuple, RID>> children;
   while (child_executor_->Next(tuple, rid, ptx)) {
+    children.emplace_back(*tuple, *rid);
+  }
+  int count = 0;
+  for (auto &[child_tuple, child_rid] : children) {
+    *tuple = std::move(child_tuple);
+    *rid = child_rid;
     if (table_heap_->MarkDelete(*rid, exec_ctx_->GetTransaction())) {
       try {
         if (!exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE,
@@ -53,7 +63,8 @@ auto DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid, ProcessRecord
       }
       auto indexs = exec_ctx_->GetCatalog()->GetTableIndexes(table_name_);
       for (auto index : indexs) {
-        auto key = (*tuple).KeyFromTuple(table_info_->schema_, index->key_schema_, index->index_->GetKeyAttrs());
+        auto key = (*tuple).KeyFromTuple(table_info_->schema_, *index->index_->GetStoredSchema(),
+                                         index->index_->GetStoredAttrs());
         index->index_->DeleteEntry(key, *rid, exec_ctx_->GetTransaction());
       }
       count++;
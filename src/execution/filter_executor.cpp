@@ -32,4 +32,29 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) ->
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  const auto &child_schema = child_executor_->GetOutputSchema();
+
+  while (child_executor_->NextBatch(batch, ptx)) {
+    // Move the tuples that qualify to the front of the batch, in order.
+    size_t kept = 0;
+    for (size_t i = 0; i < batch->Size(); i++) {
+      auto value = filter_expr->Evaluate(&batch->GetTuple(i), child_schema);
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        if (ptx) ptx->AddToExecRecorder(plan_, batch->GetTuple(i));
+        if (kept != i) {
+          batch->MoveTuple(i, kept);
+        }
+        kept++;
+      }
+    }
+    if (kept > 0) {
+      batch->Truncate(kept);
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
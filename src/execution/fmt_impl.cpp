@@ -7,6 +7,7 @@
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/aggregation_plan.h"
+#include "execution/plans/hash_join_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/projection_plan.h"
 #include "execution/plans/sort_plan.h"
@@ -36,6 +37,15 @@ auto AggregationPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Agg {{ types={}, aggregates={}, group_by={} }}", agg_types_, aggregates_, group_bys_);
 }
 
+auto HashJoinPlanNode::PlanNodeToString() const -> std::string {
+  if (build_left_) {
+    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={}, build=left }}", join_type_,
+                       left_key_expressions_, right_key_expressions_);
+  }
+  return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expressions_,
+                     right_key_expressions_);
+}
+
 auto ProjectionPlanNode::PlanNodeToString() const -> std::string {
   return fmt::format("Projection {{ exprs={} }}", expressions_);
 }
@@ -63,6 +73,13 @@ void AggregationPlanNode::PlanNodeToJSON(rapidjson::Value &json_attr, rapidjson_
   
 }
 
+void HashJoinPlanNode::PlanNodeToJSON(rapidjson::Value &json_attr, rapidjson_allocator_t &json_alloc) const {
+  json_attr.AddMember("type", rapidjson::Value(fmt::format("{}", join_type_).c_str(), json_alloc), json_alloc);
+  json_attr.AddMember("left_key", rapidjson::Value(fmt::format("{}", left_key_expressions_).c_str(), json_alloc), json_alloc);
+  json_attr.AddMember("right_key", rapidjson::Value(fmt::format("{}", right_key_expressions_).c_str(), json_alloc), json_alloc);
+  json_attr.AddMember("build_left", build_left_, json_alloc);
+}
+
 void ProjectionPlanNode::PlanNodeToJSON(rapidjson::Value &json_attr, rapidjson_allocator_t &json_alloc) const {
   json_attr.AddMember(
     "expressions", 
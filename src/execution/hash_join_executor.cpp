@@ -12,27 +12,448 @@
 
 #include "execution/executors/hash_join_executor.h"
 
-// Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
-// if you want to get faster in leaderboard tests.
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "binder/table_ref/bound_join_ref.h"
+#include "common/config.h"
+#include "common/exception.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
+void JoinHashTable::Clear() {
+  tuples_.clear();
+  keys_.clear();
+  key_size_ = 0;
+  hashes_.clear();
+  next_.clear();
+  slots_.clear();
+  slot_offsets_.clear();
+  radix_bits_ = 0;
+}
+
+void JoinHashTable::Insert(Tuple &&tuple, std::vector<Value> &&key, hash_t hash) {
+  key_size_ = key.size();
+  hashes_.push_back(hash);
+  for (auto &value : key) {
+    keys_.push_back(std::move(value));
+  }
+  tuples_.push_back(std::move(tuple));
+}
+
+void JoinHashTable::Build() {
+  const size_t size = tuples_.size();
+  size_t partitions = 1;
+  radix_bits_ = 0;
+  while (partitions * HASH_JOIN_PARTITION_SIZE < size) {
+    partitions <<= 1;
+    radix_bits_++;
+  }
+
+  // Count the tuples of each partition, then move them so that every partition is contiguous. The sort is stable, so
+  // the tuples of a partition keep the order they were inserted in.
+  std::vector<size_t> starts(partitions + 1, 0);
+  for (hash_t hash : hashes_) {
+    starts[PartitionOf(hash) + 1]++;
+  }
+  for (size_t p = 0; p < partitions; p++) {
+    starts[p + 1] += starts[p];
+  }
+  if (partitions > 1) {
+    std::vector<size_t> positions(starts.begin(), starts.end() - 1);
+    std::vector<Tuple> tuples(size);
+    std::vector<Value> keys(keys_.size());
+    std::vector<hash_t> hashes(size);
+    for (size_t i = 0; i < size; i++) {
+      const size_t to = positions[PartitionOf(hashes_[i])]++;
+      tuples[to] = std::move(tuples_[i]);
+      for (size_t k = 0; k < key_size_; k++) {
+        keys[to * key_size_ + k] = std::move(keys_[i * key_size_ + k]);
+      }
+      hashes[to] = hashes_[i];
+    }
+    tuples_ = std::move(tuples);
+    keys_ = std::move(keys);
+    hashes_ = std::move(hashes);
+  }
+
+  // Every partition gets a power-of-two number of slots, at least twice its tuple count.
+  slot_offsets_.assign(partitions + 1, 0);
+  for (size_t p = 0; p < partitions; p++) {
+    size_t slot_count = 2;
+    while (slot_count < 2 * (starts[p + 1] - starts[p])) {
+      slot_count <<= 1;
+    }
+    slot_offsets_[p + 1] = slot_offsets_[p] + slot_count;
+  }
+  slots_.assign(slot_offsets_[partitions], Slot{});
+  next_.assign(size, NO_ENTRY);
+
+  // Inserting back to front puts the earliest tuple of a hash at the head of its chain.
+  for (size_t p = 0; p < partitions; p++) {
+    Slot *slots = &slots_[slot_offsets_[p]];
+    const size_t mask = slot_offsets_[p + 1] - slot_offsets_[p] - 1;
+    for (size_t i = starts[p + 1]; i-- > starts[p];) {
+      const hash_t hash = hashes_[i];
+      size_t pos = hash & mask;
+      while (slots[pos].head_ != NO_ENTRY && slots[pos].hash_ != hash) {
+        pos = (pos + 1) & mask;
+      }
+      if (slots[pos].head_ == NO_ENTRY) {
+        slots[pos].hash_ = hash;
+      }
+      next_[i] = slots[pos].head_;
+      slots[pos].head_ = static_cast<uint32_t>(i);
+    }
+  }
+}
+
+auto JoinHashTable::Find(const std::vector<Value> &key, hash_t hash) const -> uint32_t {
+  if (tuples_.empty()) {
+    return NO_ENTRY;
+  }
+  const size_t partition = PartitionOf(hash);
+  const Slot *slots = &slots_[slot_offsets_[partition]];
+  const size_t mask = slot_offsets_[partition + 1] - slot_offsets_[partition] - 1;
+  size_t pos = hash & mask;
+  while (slots[pos].head_ != NO_ENTRY && slots[pos].hash_ != hash) {
+    pos = (pos + 1) & mask;
+  }
+  uint32_t entry = slots[pos].head_;
+  while (entry != NO_ENTRY && !KeyEquals(entry, key)) {
+    entry = next_[entry];
+  }
+  return entry;
+}
+
+auto JoinHashTable::FindNext(uint32_t entry, const std::vector<Value> &key) const -> uint32_t {
+  entry = next_[entry];
+  while (entry != NO_ENTRY && !KeyEquals(entry, key)) {
+    entry = next_[entry];
+  }
+  return entry;
+}
+
+auto JoinHashTable::HashKey(const std::vector<Value> &key) -> hash_t {
+  hash_t hash = 0;
+  for (const auto &value : key) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&value));
+  }
+  return HashUtil::MixHash(hash);
+}
+
+auto JoinHashTable::KeyEquals(uint32_t entry, const std::vector<Value> &key) const -> bool {
+  for (size_t k = 0; k < key_size_; k++) {
+    if (keys_[entry * key_size_ + k].CompareEquals(key[k]) != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TmpTupleFile::~TmpTupleFile() {
+  if (last_page_ != nullptr) {
+    bpm_->UnpinPage(last_page_->GetPageId(), true);
+  }
+  for (size_t i = next_read_; i < page_ids_.size(); i++) {
+    bpm_->DeletePage(page_ids_[i]);
+  }
+}
+
+void TmpTupleFile::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (last_page_ != nullptr && last_page_->Insert(tuple, &tmp_tuple)) {
+    return;
+  }
+  if (last_page_ != nullptr) {
+    bpm_->UnpinPage(last_page_->GetPageId(), true);
+    last_page_ = nullptr;
+  }
+  page_id_t page_id;
+  auto *page = bpm_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception("no free frame for a page of a spilled hash join partition");
+  }
+  last_page_ = reinterpret_cast<TmpTuplePage *>(page);
+  last_page_->Init(page_id, bustub_page_size);
+  page_ids_.push_back(page_id);
+  if (!last_page_->Insert(tuple, &tmp_tuple)) {
+    throw Exception("tuple does not fit in a page of a spilled hash join partition");
+  }
+}
+
+auto TmpTupleFile::ReadPage(std::vector<Tuple> *tuples) -> bool {
+  if (last_page_ != nullptr) {
+    bpm_->UnpinPage(last_page_->GetPageId(), true);
+    last_page_ = nullptr;
+  }
+  if (next_read_ == page_ids_.size()) {
+    return false;
+  }
+  const page_id_t page_id = page_ids_[next_read_++];
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception("no free frame for a page of a spilled hash join partition");
+  }
+  // The page is filled from its end, so reading it from the start gives the tuples newest first.
+  tuples->clear();
+  for (size_t offset = page->GetFreeSpacePointer(); offset < static_cast<size_t>(bustub_page_size);) {
+    offset = page->Get(offset, &tuples->emplace_back());
+  }
+  std::reverse(tuples->begin(), tuples->end());
+  bpm_->UnpinPage(page_id, false);
+  bpm_->DeletePage(page_id);
+  return true;
+}
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {
+    : AbstractExecutor(exec_ctx), plan_(plan) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  // A left join must see every left tuple once, so only the right input can be built on.
+  BUSTUB_ENSURE(!plan->build_left_ || plan->GetJoinType() == JoinType::INNER, "only an inner join can build on left");
+  if (plan_->build_left_) {
+    build_executor_ = std::move(left_child);
+    probe_executor_ = std::move(right_child);
+    build_key_exprs_ = &plan_->LeftJoinKeyExpressions();
+    probe_key_exprs_ = &plan_->RightJoinKeyExpressions();
+  } else {
+    build_executor_ = std::move(right_child);
+    probe_executor_ = std::move(left_child);
+    build_key_exprs_ = &plan_->RightJoinKeyExpressions();
+    probe_key_exprs_ = &plan_->LeftJoinKeyExpressions();
+  }
+}
+
+void HashJoinExecutor::Init(ProcessRecordContext *ptx) {
+  build_executor_->Init(ptx);
+  probe_executor_->Init(ptx);
+
+  partitions_.clear();
+  partitions_.resize(HASH_JOIN_SPILL_FANOUT);
+  partition_bytes_.assign(HASH_JOIN_SPILL_FANOUT, 0);
+  memory_used_ = 0;
+  build_spills_.clear();
+  build_spills_.resize(HASH_JOIN_SPILL_FANOUT);
+  probe_spills_.clear();
+  probe_spills_.resize(HASH_JOIN_SPILL_FANOUT);
+
+  const size_t memory_budget = exec_ctx_->GetHashJoinMemoryBudget();
+  TupleBatch batch;
+  std::vector<Value> key;
+  while (build_executor_->NextBatch(&batch, ptx)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      AddBuildTuple(std::move(batch.GetTuple(i)), &key, memory_budget);
+    }
+  }
+  for (size_t partition = 0; partition < HASH_JOIN_SPILL_FANOUT; partition++) {
+    if (build_spills_[partition] == nullptr) {
+      partitions_[partition].Build();
+    }
+  }
+
+  reading_probe_input_ = true;
+  probe_batch_.Clear();
+  probe_batch_pos_ = 0;
+  next_spilled_partition_ = 0;
+  probe_page_.clear();
+  probe_page_pos_ = 0;
+  probe_partition_ = HASH_JOIN_SPILL_FANOUT;
+  has_probe_tuple_ = false;
+  match_ = JoinHashTable::NO_ENTRY;
+  ResetBatchAdapter();
+}
+
+void HashJoinExecutor::AddBuildTuple(Tuple &&tuple, std::vector<Value> *key, size_t memory_budget) {
+  if (!MakeKey(*build_key_exprs_, tuple, build_executor_->GetOutputSchema(), key)) {
+    return;
+  }
+  const hash_t hash = JoinHashTable::HashKey(*key);
+  const size_t partition = SpillPartitionOf(hash);
+  if (build_spills_[partition] != nullptr) {
+    build_spills_[partition]->Append(tuple);
+    return;
+  }
+  const size_t bytes = JoinHashTable::EntrySize(tuple, key->size());
+  partitions_[partition].Insert(std::move(tuple), std::move(*key), hash);
+  partition_bytes_[partition] += bytes;
+  memory_used_ += bytes;
+  while (memory_used_ > memory_budget && SpillLargestPartition()) {
+  }
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
+  return NextFromBatch(tuple, rid, ptx);
+}
+
+auto HashJoinExecutor::NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+  batch->Clear();
+  while (!batch->IsFull()) {
+    if (has_probe_tuple_) {
+      if (match_ != JoinHashTable::NO_ENTRY) {
+        const auto &table = partitions_[probe_partition_];
+        const uint32_t entry = match_;
+        match_ = table.FindNext(entry, probe_key_);
+        probe_matched_ = true;
+        Emit(&table.GetTuple(entry), batch, ptx);
+        continue;
+      }
+      has_probe_tuple_ = false;
+      if (plan_->GetJoinType() == JoinType::LEFT && !probe_matched_) {
+        Emit(nullptr, batch, ptx);
+        continue;
+      }
+    }
+
+    if (!NextProbeTuple(ptx)) {
+      break;
+    }
+    has_probe_tuple_ = true;
+    probe_matched_ = false;
+  }
+  return !batch->IsEmpty();
+}
+
+auto HashJoinExecutor::SpillLargestPartition() -> bool {
+  size_t largest = HASH_JOIN_SPILL_FANOUT;
+  for (size_t partition = 0; partition < HASH_JOIN_SPILL_FANOUT; partition++) {
+    if (build_spills_[partition] == nullptr &&
+        (largest == HASH_JOIN_SPILL_FANOUT || partition_bytes_[partition] > partition_bytes_[largest])) {
+      largest = partition;
+    }
+  }
+  if (largest == HASH_JOIN_SPILL_FANOUT) {
+    return false;
+  }
+
+  auto *bpm = exec_ctx_->GetBufferPoolManager();
+  build_spills_[largest] = std::make_unique<TmpTupleFile>(bpm);
+  probe_spills_[largest] = std::make_unique<TmpTupleFile>(bpm);
+  auto &table = partitions_[largest];
+  for (uint32_t entry = 0; entry < table.Size(); entry++) {
+    build_spills_[largest]->Append(table.GetTuple(entry));
+  }
+  table.Clear();
+  memory_used_ -= partition_bytes_[largest];
+  partition_bytes_[largest] = 0;
+  return true;
+}
+
+auto HashJoinExecutor::NextProbeTuple(ProcessRecordContext *ptx) -> bool {
+  while (reading_probe_input_) {
+    if (probe_batch_pos_ == probe_batch_.Size()) {
+      probe_batch_pos_ = 0;
+      if (probe_executor_->NextBatch(&probe_batch_, ptx)) {
+        continue;
+      }
+      // The partitions in memory are done with; the spilled ones are loaded into their place one at a time.
+      for (size_t partition = 0; partition < HASH_JOIN_SPILL_FANOUT; partition++) {
+        partitions_[partition].Clear();
+      }
+      memory_used_ = 0;
+      reading_probe_input_ = false;
+      probe_partition_ = HASH_JOIN_SPILL_FANOUT;
+      break;
+    }
+    probe_tuple_ = std::move(probe_batch_.GetTuple(probe_batch_pos_++));
+    if (!MakeKey(*probe_key_exprs_, probe_tuple_, probe_executor_->GetOutputSchema(), &probe_key_)) {
+      match_ = JoinHashTable::NO_ENTRY;
+      return true;
+    }
+    const hash_t hash = JoinHashTable::HashKey(probe_key_);
+    const size_t partition = SpillPartitionOf(hash);
+    if (probe_spills_[partition] != nullptr) {
+      probe_spills_[partition]->Append(probe_tuple_);
+      continue;
+    }
+    probe_partition_ = partition;
+    match_ = partitions_[partition].Find(probe_key_, hash);
+    return true;
+  }
+
+  while (true) {
+    if (probe_page_pos_ < probe_page_.size()) {
+      probe_tuple_ = std::move(probe_page_[probe_page_pos_++]);
+      MakeKey(*probe_key_exprs_, probe_tuple_, probe_executor_->GetOutputSchema(), &probe_key_);
+      match_ = partitions_[probe_partition_].Find(probe_key_, JoinHashTable::HashKey(probe_key_));
+      return true;
+    }
+    probe_page_pos_ = 0;
+    if (probe_partition_ != HASH_JOIN_SPILL_FANOUT && probe_spills_[probe_partition_]->ReadPage(&probe_page_)) {
+      continue;
+    }
+    probe_page_.clear();
+    if (!LoadNextSpilledPartition()) {
+      return false;
+    }
+  }
+}
+
+auto HashJoinExecutor::LoadNextSpilledPartition() -> bool {
+  if (probe_partition_ != HASH_JOIN_SPILL_FANOUT) {
+    partitions_[probe_partition_].Clear();
+    build_spills_[probe_partition_].reset();
+    probe_spills_[probe_partition_].reset();
+  }
+  while (next_spilled_partition_ < HASH_JOIN_SPILL_FANOUT && build_spills_[next_spilled_partition_] == nullptr) {
+    next_spilled_partition_++;
+  }
+  if (next_spilled_partition_ == HASH_JOIN_SPILL_FANOUT) {
+    probe_partition_ = HASH_JOIN_SPILL_FANOUT;
+    return false;
+  }
+  probe_partition_ = next_spilled_partition_++;
+
+  auto &table = partitions_[probe_partition_];
+  std::vector<Tuple> tuples;
+  std::vector<Value> key;
+  while (build_spills_[probe_partition_]->ReadPage(&tuples)) {
+    for (auto &tuple : tuples) {
+      MakeKey(*build_key_exprs_, tuple, build_executor_->GetOutputSchema(), &key);
+      const hash_t hash = JoinHashTable::HashKey(key);
+      table.Insert(std::move(tuple), std::move(key), hash);
+    }
+  }
+  table.Build();
+  return true;
 }
 
-void HashJoinExecutor::Init(ProcessRecordContext *ptx) { 
-  throw NotImplementedException("HashJoinExecutor is not implemented"); 
+auto HashJoinExecutor::MakeKey(const std::vector<AbstractExpressionRef> &exprs, const Tuple &tuple,
+                               const Schema &schema, std::vector<Value> *key) -> bool {
+  key->clear();
+  for (const auto &expr : exprs) {
+    key->push_back(expr->Evaluate(&tuple, schema));
+    if (key->back().IsNull()) {
+      return false;
+    }
+  }
+  return true;
 }
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool { 
-  return false; 
+void HashJoinExecutor::Emit(const Tuple *build_tuple, TupleBatch *batch, ProcessRecordContext *ptx) {
+  const Schema &left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const Schema &right_schema = plan_->GetRightPlan()->OutputSchema();
+  const Tuple *left_tuple = plan_->build_left_ ? build_tuple : &probe_tuple_;
+  const Tuple *right_tuple = plan_->build_left_ ? &probe_tuple_ : build_tuple;
+
+  values_.clear();
+  for (uint32_t i = 0; i < left_schema.GetColumnCount(); i++) {
+    values_.push_back(left_tuple->GetValue(&left_schema, i));
+  }
+  for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+    values_.push_back(right_tuple != nullptr ? right_tuple->GetValue(&right_schema, i)
+                                             : ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+  }
+
+  Tuple tuple{values_, &GetOutputSchema()};
+  if (ptx) ptx->AddToExecRecorder(plan_, tuple);
+  batch->Append(std::move(tuple), RID{});
 }
 
 }  // namespace bustub
@@ -11,27 +11,113 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <type_traits>
+
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx), plan_(plan) {}
 
 void IndexScanExecutor::Init(ProcessRecordContext *ptx) {
-  auto index_info = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
-  index_ = dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info->index_.get());
-  iterator_ = std::make_unique<BPlusTreeIndexIteratorForOneIntegerColumn>(index_->GetBeginIterator());
-  table_heap_ = exec_ctx_->GetCatalog()->GetTable(index_info->table_name_)->table_.get();
+  index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid());
+  table_heap_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)->table_.get();
+  DispatchIndexKeySize(index_info_->key_size_, [&](auto key_size) {
+    auto *index = dynamic_cast<BPlusTreeIndexForKeySize<decltype(key_size)::value> *>(index_info_->index_.get());
+    if (plan_->lower_bound_.empty()) {
+      iterator_ = index->GetBeginIterator();
+      return;
+    }
+    // Seek straight to the first key that can be in range instead of walking from the leftmost leaf. Columns past the
+    // bound take their smallest value, so the seek lands before every key starting with the bound.
+    const Schema *key_schema = index->GetKeySchema();
+    std::vector<Value> values = plan_->lower_bound_;
+    for (uint32_t i = values.size(); i < key_schema->GetColumnCount(); i++) {
+      values.push_back(Type::GetMinValue(key_schema->GetColumn(i).GetType()));
+    }
+    iterator_ = index->GetBeginIterator(Tuple(values, key_schema));
+  });
+}
+
+auto IndexScanExecutor::ComparePrefix(const std::vector<Value> &key_values, const std::vector<Value> &bound) const
+    -> int {
+  for (size_t i = 0; i < bound.size(); i++) {
+    if (key_values[i].CompareLessThan(bound[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (key_values[i].CompareGreaterThan(bound[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <size_t KeySize>
+auto IndexScanExecutor::NextEntry(BPlusTreeIndexIteratorForKeySize<KeySize> *iterator, RID *rid, Tuple *tuple)
+    -> bool {
+  Schema *key_schema = index_info_->index_->GetKeySchema();
+  const size_t num_bound_columns = std::max(plan_->lower_bound_.size(), plan_->upper_bound_.size());
+  std::vector<Value> key_values;
+  while (!iterator->IsEnd()) {
+    const auto &[key, value] = **iterator;
+    key_values.clear();
+    for (uint32_t i = 0; i < num_bound_columns; i++) {
+      key_values.push_back(key.ToValue(key_schema, i));
+    }
+    if (!plan_->lower_bound_.empty() && !plan_->lower_inclusive_ && ComparePrefix(key_values, plan_->lower_bound_) == 0) {
+      ++(*iterator);
+      continue;
+    }
+    if (!plan_->upper_bound_.empty()) {
+      int cmp = ComparePrefix(key_values, plan_->upper_bound_);
+      if (cmp > 0 || (cmp == 0 && !plan_->upper_inclusive_)) {
+        return false;
+      }
+    }
+    *rid = value;
+    if (plan_->index_only_) {
+      const Schema &schema = plan_->OutputSchema();
+      std::vector<Value> values;
+      values.reserve(schema.GetColumnCount());
+      for (const auto &column : schema.GetColumns()) {
+        values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+      }
+      const auto &stored_attrs = index_info_->index_->GetStoredAttrs();
+      auto stored_values =
+          static_cast<BPlusTreeIndexForKeySize<KeySize> *>(index_info_->index_.get())->StoredValues(key);
+      for (size_t i = 0; i < stored_attrs.size(); i++) {
+        values[stored_attrs[i]] = std::move(stored_values[i]);
+      }
+      *tuple = Tuple(values, &schema);
+    }
+    ++(*iterator);
+    return true;
+  }
+  return false;
 }
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
-  if (*iterator_ != index_->GetEndIterator()) {
-    *rid = (**iterator_).second;
-    if (table_heap_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
-      iterator_->operator++();
+  while (true) {
+    bool found = std::visit(
+        [&](auto &iterator) {
+          if constexpr (std::is_same_v<std::decay_t<decltype(iterator)>, std::monostate>) {
+            return false;
+          } else {
+            return NextEntry(&iterator, rid, tuple);
+          }
+        },
+        iterator_);
+    if (!found) {
+      // Keys are sorted, nothing further can match; let go of the leaf now rather than at destruction.
+      iterator_ = std::monostate{};
+      return false;
+    }
+    if (plan_->index_only_ || table_heap_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
       if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
       return true;
     }
   }
-  return false;
 }
 
 }  // namespace bustub
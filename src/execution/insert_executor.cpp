@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -40,8 +42,15 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid, ProcessRecord
   if (successful_) {
     return false;
   }
-  int count = 0;
+  // Read all tuples to insert first. The input may be an index scan of the same table, which keeps its current leaf
+  // latched while the new index entries would wait on it.
+  std::vector<Tuple> children;
   while (child_executor_->Next(tuple, rid, ptx)) {
+    children.push_back(*tuple);
+  }
+  int count = 0;
+  for (auto &child_tuple : children) {
+    *tuple = std::move(child_tuple);
     if (table_heap_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction())) {
       try {
         if (!exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE,
@@ -53,7 +62,8 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid, ProcessRecord
       }
       auto indexs = exec_ctx_->GetCatalog()->GetTableIndexes(table_name_);
       for (auto index : indexs) {
-        auto key = (*tuple).KeyFromTuple(table_info_->schema_, index->key_schema_, index->index_->GetKeyAttrs());
+        auto key = (*tuple).KeyFromTuple(table_info_->schema_, *index->index_->GetStoredSchema(),
+                                         index->index_->GetStoredAttrs());
         index->index_->InsertEntry(key, *rid, exec_ctx_->GetTransaction());
       }
       count++;
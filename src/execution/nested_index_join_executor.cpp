@@ -11,6 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_index_join_executor.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "storage/index/b_plus_tree_index.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -25,58 +30,121 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
   is_ineer_ = (plan->GetJoinType() == JoinType::INNER);
   index_info_ = exec_ctx->GetCatalog()->GetIndex(plan_->GetIndexOid());
   table_info_ = exec_ctx->GetCatalog()->GetTable(plan_->GetInnerTableOid());
+  key_is_lossy_ = IsLossyIndexKey(*index_info_->index_->GetKeySchema());
 }
 
-void NestIndexJoinExecutor::Init(ProcessRecordContext *ptx) { 
-  child_executor_->Init(ptx); 
+void NestIndexJoinExecutor::Init(ProcessRecordContext *ptx) {
+  child_executor_->Init(ptx);
+  left_tuples_.clear();
+  right_tuples_.clear();
+  next_left_ = 0;
+  next_right_ = 0;
 }
 
 auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
-  Tuple left_tuple;
-  RID left_rid;
-  while (child_executor_->Next(&left_tuple, &left_rid, ptx)) {
-    auto key_schema = index_info_->index_->GetKeySchema();
-    auto value = plan_->KeyPredicate()->Evaluate(&left_tuple, child_executor_->GetOutputSchema());
-    std::vector<Value> values;
-    values.push_back(value);
-    Tuple key(values, key_schema);
-    std::vector<RID> results;
-    index_info_->index_->ScanKey(key, &results, exec_ctx_->GetTransaction());
-    if (!results.empty()) {
-      for (auto result : results) {
-        Tuple right_tuple;
-        if (table_info_->table_->GetTuple(result, &right_tuple, exec_ctx_->GetTransaction())) {
-          std::vector<Value> tuple_values;
-          for (uint32_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
-            tuple_values.push_back(left_tuple.GetValue(&child_executor_->GetOutputSchema(), i));
-          }
-          for (uint32_t i = 0; i < table_info_->schema_.GetColumnCount(); i++) {
-            tuple_values.push_back(right_tuple.GetValue(&table_info_->schema_, i));
-          }
-
-          *tuple = {tuple_values, &plan_->OutputSchema()};
-          if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-
-          return true;
-        }
-      }
+  while (true) {
+    if (next_left_ == left_tuples_.size() && !NextBatch(ptx)) {
+      return false;
     }
-    if (!is_ineer_) {
-      std::vector<Value> tuple_values;
-      for (uint32_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
-        tuple_values.push_back(left_tuple.GetValue(&child_executor_->GetOutputSchema(), i));
+    const Tuple &left_tuple = left_tuples_[next_left_];
+    const auto &right_tuples = right_tuples_[next_left_];
+    if (next_right_ == right_tuples.size()) {
+      next_left_++;
+      next_right_ = 0;
+      if (!right_tuples.empty() || is_ineer_) {
+        continue;
       }
+    }
+    std::vector<Value> tuple_values;
+    for (uint32_t i = 0; i < child_executor_->GetOutputSchema().GetColumnCount(); i++) {
+      tuple_values.push_back(left_tuple.GetValue(&child_executor_->GetOutputSchema(), i));
+    }
+    if (right_tuples.empty()) {
       for (uint32_t i = 0; i < table_info_->schema_.GetColumnCount(); i++) {
         tuple_values.push_back(ValueFactory::GetNullValueByType(table_info_->schema_.GetColumn(i).GetType()));
       }
+    } else {
+      const Tuple &right_tuple = right_tuples[next_right_++];
+      for (uint32_t i = 0; i < table_info_->schema_.GetColumnCount(); i++) {
+        tuple_values.push_back(right_tuple.GetValue(&table_info_->schema_, i));
+      }
+    }
+
+    *tuple = {tuple_values, &plan_->OutputSchema()};
+    if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
+
+    return true;
+  }
+}
+
+auto NestIndexJoinExecutor::NextBatch(ProcessRecordContext *ptx) -> bool {
+  left_tuples_.clear();
+  right_tuples_.clear();
+  next_left_ = 0;
+  next_right_ = 0;
+  auto key_schema = index_info_->index_->GetKeySchema();
+  std::vector<Tuple> keys;
+  std::vector<Value> probe_values;
+  std::vector<size_t> key_owners;
+  Tuple left_tuple;
+  RID left_rid;
+  while (left_tuples_.size() < INDEX_JOIN_BATCH_SIZE && child_executor_->Next(&left_tuple, &left_rid, ptx)) {
+    Value probe_value = ProbeValue(left_tuple);
+    if (!probe_value.IsNull()) {
+      keys.emplace_back(std::vector<Value>{probe_value}, key_schema);
+      probe_values.push_back(probe_value);
+      key_owners.push_back(left_tuples_.size());
+    }
+    left_tuples_.push_back(left_tuple);
+  }
+  if (left_tuples_.empty()) {
+    return false;
+  }
+  right_tuples_.resize(left_tuples_.size());
+  // An index that is not unique has any number of entries for a key.
+  std::vector<std::vector<RID>> matches;
+  index_info_->index_->ScanKeys(keys, &matches, exec_ctx_->GetTransaction());
+
+  std::vector<std::pair<size_t, RID>> fetches;
+  for (size_t i = 0; i < matches.size(); i++) {
+    for (const RID &rid : matches[i]) {
+      fetches.emplace_back(i, rid);
+    }
+  }
+  std::vector<size_t> fetch_order(fetches.size());
+  std::iota(fetch_order.begin(), fetch_order.end(), 0);
+  std::sort(fetch_order.begin(), fetch_order.end(),
+            [&](size_t a, size_t b) { return fetches[a].second.Get() < fetches[b].second.Get(); });
+  std::vector<Tuple> fetched(fetches.size());
+  std::vector<bool> found(fetches.size());
+  const uint32_t key_attr = index_info_->index_->GetKeyAttrs()[0];
+  for (size_t j : fetch_order) {
+    const auto &[key_index, rid] = fetches[j];
+    found[j] = table_info_->table_->GetTuple(rid, &fetched[j], exec_ctx_->GetTransaction()) &&
+               (!key_is_lossy_ || fetched[j].GetValue(&table_info_->schema_, key_attr)
+                                          .CompareEquals(probe_values[key_index]) == CmpBool::CmpTrue);
+  }
+  // Inner tuples keep the order the index returned them in.
+  for (size_t j = 0; j < fetches.size(); j++) {
+    if (found[j]) {
+      right_tuples_[key_owners[fetches[j].first]].push_back(std::move(fetched[j]));
+    }
+  }
+  return true;
+}
 
-      *tuple = {tuple_values, &plan_->OutputSchema()};
-      if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-      
-      return true;
+auto NestIndexJoinExecutor::ProbeValue(const Tuple &left_tuple) const -> Value {
+  Value probe_value = plan_->KeyPredicate()->Evaluate(&left_tuple, child_executor_->GetOutputSchema());
+  // The key is encoded in the indexed column's type; a value that does not convert cannot match.
+  auto key_type = index_info_->index_->GetKeySchema()->GetColumn(0).GetType();
+  if (!probe_value.IsNull() && probe_value.GetTypeId() != key_type) {
+    try {
+      probe_value = probe_value.CastAs(key_type);
+    } catch (const Exception &) {
+      probe_value = ValueFactory::GetNullValueByType(key_type);
     }
   }
-  return false;
+  return probe_value;
 }
 
 }  // namespace bustub
@@ -30,158 +30,79 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
-  is_ineer_ = (plan_->GetJoinType() == JoinType::INNER);
 }
 
 void NestedLoopJoinExecutor::Init(ProcessRecordContext *ptx) {
-  Tuple tuple;
-  RID rid;
   left_executor_->Init(ptx);
   right_executor_->Init(ptx);
-  while (right_executor_->Next(&tuple, &rid, ptx)) {
-    right_tuples_.push_back(tuple);
+  right_tuples_.clear();
+  TupleBatch batch;
+  while (right_executor_->NextBatch(&batch, ptx)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      right_tuples_.push_back(std::move(batch.GetTuple(i)));
+    }
   }
+  left_batch_.Clear();
+  left_pos_ = 0;
+  right_pos_ = 0;
+  left_matched_ = false;
+  left_done_ = false;
+  ResetBatchAdapter();
 }
 
 auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
-  std::vector<Column> columns(left_schema_.GetColumns());
-  for (const auto &column : right_schema_.GetColumns()) {
-    columns.push_back(column);
-  }
-  Schema schema(columns);
-  if (is_ineer_) {
-    return InnerJoin(schema, tuple, ptx);
-  }
-  return LeftJoin(schema, tuple, ptx);
+  return NextFromBatch(tuple, rid, ptx);
 }
 
-auto NestedLoopJoinExecutor::InnerJoin(const Schema &schema, Tuple *tuple, ProcessRecordContext *ptx) -> bool {
-  if (index_ > right_tuples_.size()) {
-    return false;
-  }
-  if (index_ != 0) {
-    for (uint32_t j = index_; j < right_tuples_.size(); j++) {
-      index_ = (index_ + 1) % right_tuples_.size();
-      if (plan_->Predicate().EvaluateJoin(&left_tuple_, left_schema_, &right_tuples_[j], right_schema_).GetAs<bool>()) {
-        std::vector<Value> value;
-        for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-          value.push_back(left_tuple_.GetValue(&left_schema_, i));
-        }
-        for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-          value.push_back(right_tuples_[j].GetValue(&right_schema_, i));
-        }
-
-        *tuple = {value, &schema};
-        if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-
-        return true;
+auto NestedLoopJoinExecutor::NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+  batch->Clear();
+  while (!batch->IsFull()) {
+    if (left_pos_ == left_batch_.Size()) {
+      left_pos_ = 0;
+      if (left_done_ || !left_executor_->NextBatch(&left_batch_, ptx)) {
+        left_batch_.Clear();
+        left_done_ = true;
+        break;
       }
     }
-  }
-  if (index_ == 0) {
-    while (left_executor_->Next(&left_tuple_, &left_rid_, ptx)) {
-      for (const auto &right_tuple : right_tuples_) {
-        index_ = (index_ + 1) % right_tuples_.size();
-        if (plan_->Predicate().EvaluateJoin(&left_tuple_, left_schema_, &right_tuple, right_schema_).GetAs<bool>()) {
-          std::vector<Value> value;
-          for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-            value.push_back(left_tuple_.GetValue(&left_schema_, i));
-          }
-          for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-            value.push_back(right_tuple.GetValue(&right_schema_, i));
-          }
-
-          *tuple = {value, &schema};
-          if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-          
-          return true;
-        }
+    const Tuple &left_tuple = left_batch_.GetTuple(left_pos_);
+    for (; right_pos_ < right_tuples_.size() && !batch->IsFull(); right_pos_++) {
+      const Tuple &right_tuple = right_tuples_[right_pos_];
+      auto value = plan_->Predicate().EvaluateJoin(&left_tuple, left_schema_, &right_tuple, right_schema_);
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        left_matched_ = true;
+        Emit(left_tuple, &right_tuple, batch, ptx);
       }
     }
-    index_ = right_tuples_.size() + 1;
-  }
-  return false;
-}
-
-auto NestedLoopJoinExecutor::LeftJoin(const Schema &schema, Tuple *tuple, ProcessRecordContext *ptx) -> bool {
-  if (index_ > right_tuples_.size()) {
-    return false;
-  }
-  if (index_ != 0) {
-    for (uint32_t j = index_; j < right_tuples_.size(); j++) {
-      index_ = (index_ + 1) % right_tuples_.size();
-      if (plan_->Predicate().EvaluateJoin(&left_tuple_, left_schema_, &right_tuples_[j], right_schema_).GetAs<bool>()) {
-        std::vector<Value> value;
-        for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-          value.push_back(left_tuple_.GetValue(&left_schema_, i));
-        }
-        for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-          value.push_back(right_tuples_[j].GetValue(&right_schema_, i));
-        }
-        is_match_ = true;
-
-        *tuple = {value, &schema};
-        if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-        
-        return true;
-      }
+    if (right_pos_ < right_tuples_.size()) {
+      break;
     }
-  }
-  if (index_ == 0) {
-    if (!is_match_) {
-      std::vector<Value> value;
-      for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-        value.push_back(left_tuple_.GetValue(&left_schema_, i));
+    if (plan_->GetJoinType() == JoinType::LEFT && !left_matched_) {
+      if (batch->IsFull()) {
+        break;
       }
-      for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-        value.push_back(ValueFactory::GetNullValueByType(right_schema_.GetColumn(i).GetType()));
-      }
-
-      *tuple = {value, &schema};
-      if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-      
-      is_match_ = true;
-      return true;
+      Emit(left_tuple, nullptr, batch, ptx);
     }
-    while (left_executor_->Next(&left_tuple_, &left_rid_, ptx)) {
-      is_match_ = false;
-      for (const auto &right_tuple : right_tuples_) {
-        index_ = (index_ + 1) % right_tuples_.size();
-        if (plan_->Predicate().EvaluateJoin(&left_tuple_, left_schema_, &right_tuple, right_schema_).GetAs<bool>()) {
-          std::vector<Value> value;
-          for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-            value.push_back(left_tuple_.GetValue(&left_schema_, i));
-          }
-          for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-            value.push_back(right_tuple.GetValue(&right_schema_, i));
-          }
-          is_match_ = true;
-
-          *tuple = {value, &schema};
-          if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-          
-          return true;
-        }
-      }
-      if (!is_match_) {
-        std::vector<Value> value;
-        for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
-          value.push_back(left_tuple_.GetValue(&left_schema_, i));
-        }
-        for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
-          value.push_back(ValueFactory::GetNullValueByType(right_schema_.GetColumn(i).GetType()));
-        }
+    left_pos_++;
+    right_pos_ = 0;
+    left_matched_ = false;
+  }
+  return !batch->IsEmpty();
+}
 
-        *tuple = {value, &schema};
-        if (ptx) ptx->AddToExecRecorder(plan_, *tuple);
-        
-        is_match_ = true;
-        return true;
-      }
-    }
-    index_ = right_tuples_.size() + 1;
+void NestedLoopJoinExecutor::Emit(const Tuple &left_tuple, const Tuple *right_tuple, TupleBatch *batch,
+                                  ProcessRecordContext *ptx) {
+  values_.clear();
+  for (uint32_t i = 0; i < left_schema_.GetColumnCount(); i++) {
+    values_.push_back(left_tuple.GetValue(&left_schema_, i));
+  }
+  for (uint32_t i = 0; i < right_schema_.GetColumnCount(); i++) {
+    values_.push_back(right_tuple != nullptr ? right_tuple->GetValue(&right_schema_, i)
+                                             : ValueFactory::GetNullValueByType(right_schema_.GetColumn(i).GetType()));
   }
-  return false;
+  Tuple tuple{values_, &GetOutputSchema()};
+  if (ptx) ptx->AddToExecRecorder(plan_, tuple);
+  batch->Append(std::move(tuple), RID{});
 }
 
 }  // namespace bustub
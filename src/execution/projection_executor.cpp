@@ -35,4 +35,25 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx)
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+  batch->Clear();
+  if (!child_executor_->NextBatch(&child_batch_, ptx)) {
+    return false;
+  }
+
+  const auto &child_schema = child_executor_->GetOutputSchema();
+  std::vector<Value> values{};
+  values.reserve(GetOutputSchema().GetColumnCount());
+  for (size_t i = 0; i < child_batch_.Size(); i++) {
+    values.clear();
+    for (const auto &expr : plan_->GetExpressions()) {
+      values.push_back(expr->Evaluate(&child_batch_.GetTuple(i), child_schema));
+    }
+    Tuple tuple{values, &GetOutputSchema()};
+    if (ptx) ptx->AddToExecRecorder(plan_, tuple);
+    batch->Append(std::move(tuple), child_batch_.GetRid(i));
+  }
+  return true;
+}
 }  // namespace bustub
@@ -64,4 +64,31 @@ auto SeqScanExecutor::Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) ->
   }
   return false;
 }
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+  batch->Clear();
+  auto *txn = exec_ctx_->GetTransaction();
+  const auto isolation_level = txn->GetIsolationLevel();
+  const auto end = table_heap_->End();
+  while (!batch->IsFull() && *iterator_ != end) {
+    const RID rid = (**iterator_).GetRid();
+    try {
+      if (isolation_level != IsolationLevel::READ_UNCOMMITTED &&
+          !exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::SHARED, plan_->GetTableOid(), rid)) {
+        throw ExecutionException("lock row  intention share failed");
+      }
+      Tuple tuple = **iterator_;
+      ++(*iterator_);
+      if (isolation_level == IsolationLevel::READ_COMMITTED &&
+          !exec_ctx_->GetLockManager()->UnlockRow(txn, plan_->GetTableOid(), rid)) {
+        throw ExecutionException("unlock row share failed");
+      }
+      if (ptx) ptx->AddToExecRecorder(plan_, tuple);
+      batch->Append(std::move(tuple), rid);
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("seq scan TransactionAbort");
+    }
+  }
+  return !batch->IsEmpty();
+}
 }  // namespace bustub
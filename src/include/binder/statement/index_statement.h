@@ -21,7 +21,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols, bool unique,
+                          std::vector<std::unique_ptr<BoundColumnRef>> included_cols = {});
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +33,12 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Whether it is a UNIQUE index, which holds at most one entry per key */
+  bool unique_;
+
+  /** Columns stored in the index entries next to the key, given by `WITH (include = 'col, ...')` */
+  std::vector<std::unique_ptr<BoundColumnRef>> included_cols_;
+
   auto ToString() const -> std::string override;
 };
 
@@ -17,6 +17,7 @@
 #include <unordered_map>
 
 #include "buffer/lru_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -40,11 +41,20 @@ class BufferPoolManager {
   /** Grading function. Do not modify! */
   auto FetchPage(page_id_t page_id, bufferpool_callback_fn callback = nullptr) -> Page * {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
-    auto *result = FetchPgImp(page_id);
+    auto *result = FetchPgImp(page_id, AccessType::Unknown);
     GradingCallback(callback, CallbackType::AFTER, page_id);
     return result;
   }
 
+  /**
+   * Fetch a page, telling the replacer how it is accessed. Sequential scans pass AccessType::Scan so that the pages
+   * they read do not displace the hot set.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
+   * @return the requested page, or nullptr if it cannot be fetched
+   */
+  auto FetchPage(page_id_t page_id, AccessType access_type) -> Page * { return FetchPgImp(page_id, access_type); }
+
   /** Grading function. Do not modify! */
   auto UnpinPage(page_id_t page_id, bool is_dirty, bufferpool_callback_fn callback = nullptr) -> bool {
     GradingCallback(callback, CallbackType::BEFORE, page_id);
@@ -87,6 +97,31 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Starts writing back dirty pages in the background before they are chosen for eviction, so that evicting a page
+   * rarely has to wait for a write. The watermarks count clean frames per BufferPoolManagerInstance.
+   * @param low_watermark the cleaner gets to work once fewer frames than this are clean ahead of eviction
+   * @param high_watermark the number of clean frames the cleaner then tries to restore
+   */
+  virtual void StartPageCleaner(size_t low_watermark, size_t high_watermark) {}
+
+  /** Stops the background page cleaner, if it is running. */
+  virtual void StopPageCleaner() {}
+
+  /**
+   * Starts reading a page into the buffer pool in the background, ahead of a sequential scan that is about to fetch
+   * it. This is only a hint: nothing happens if the page is already resident or no frame can be spared.
+   * @param page_id id of page to be read ahead
+   */
+  virtual void PrefetchPage(page_id_t page_id) {}
+
+  /**
+   * The dirty page table, for checkpoints. The recovery LSN of a page is a lower bound of the LSNs of the changes to
+   * the page that may not be on disk yet; log records before it are not needed to redo the page.
+   * @return every page that may differ from its copy on disk, with its recovery LSN
+   */
+  virtual auto GetDirtyPageTable() -> std::unordered_map<page_id_t, lsn_t> { return {}; }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -104,9 +139,10 @@ class BufferPoolManager {
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
    * @return the requested page
    */
-  virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
+  virtual auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * = 0;
 
   /**
    * Unpin the target page from the buffer pool.
@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <list>
-#include <mutex>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/lru_k_replacer.h"
@@ -22,6 +26,7 @@
 #include "container/hash/extendible_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
 #include "storage/page/page.h"
 
 namespace bustub {
@@ -41,6 +46,19 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
                             LogManager *log_manager = nullptr);
 
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in the parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr);
+
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
    */
@@ -54,6 +72,31 @@ class BufferPoolManagerInstance : public BufferPoolManager {
 
   auto GetFreeList() -> const std::list<frame_id_t> & { return free_list_; }
 
+  /**
+   * @brief Start the page cleaner thread. Every page_cleaner_interval, or sooner when an eviction had to write back a
+   * dirty page, it looks at the frames the replacer would evict next. If fewer than low_watermark of them (free frames
+   * included) are clean, it writes back dirty ones in eviction order until high_watermark frames are clean. With
+   * logging enabled, a page whose LSN is not yet persistent in the log is left alone.
+   */
+  void StartPageCleaner(size_t low_watermark, size_t high_watermark) override;
+
+  /** @brief Stop the page cleaner thread and wait for its current round to finish. */
+  void StopPageCleaner() override;
+
+  /**
+   * @brief Read a page into a frame in the background. The frame is taken from the free list or from the replacer's
+   * cold region only, and joins the cold region itself, so read-ahead never evicts a page outside of it. A fetch of
+   * the page waits for the read to complete.
+   * @param page_id id of page to be read ahead
+   */
+  void PrefetchPage(page_id_t page_id) override;
+
+  /**
+   * @brief The dirty page table of this instance. Besides the dirty frames, it holds the pinned frames, which may be
+   * modified at any time, and the evicted pages whose write-back has not completed yet.
+   */
+  auto GetDirtyPageTable() -> std::unordered_map<page_id_t, lsn_t> override;
+
  protected:
   /**
    * TODO(P1): Add implementation
@@ -88,9 +131,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * In addition, remember to disable eviction and record the access history of the frame like you did for NewPgImp().
    *
    * @param page_id id of page to be fetched
+   * @param access_type type of access to the page, passed on to the replacer
    * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
    */
-  auto FetchPgImp(page_id_t page_id) -> Page * override;
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
 
   /**
    * TODO(P1): Add implementation
@@ -144,6 +188,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
 
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
   /** Bucket size for the extendible hash table */
@@ -153,6 +201,8 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** Issues the page reads and writes of this BPI to background workers, so that they can overlap. */
+  DiskScheduler *disk_scheduler_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
@@ -161,8 +211,31 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   LRUKReplacer *replacer_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * Protects the page table, the free list, the replacer, the frame metadata and the I/O bookkeeping below.
+   * Disk reads and write-backs are never issued while holding it.
+   */
   std::mutex latch_;
+  /** True for a frame whose data is being read from or written to disk without the latch held. */
+  std::vector<bool> io_in_progress_;
+  /**
+   * Recovery LSN of every frame, or INVALID_LSN for a frame that matches the disk. It is the next LSN at the time a
+   * clean frame gets pinned, which no change made through that pin can precede, and it is only cleared once the frame
+   * is clean and unpinned.
+   */
+  std::vector<lsn_t> rec_lsn_;
+  /** Dirty pages that were evicted from their frame but whose write-back has not completed yet, with their rec LSNs. */
+  std::unordered_map<page_id_t, lsn_t> evicting_pages_;
+  /** Signaled whenever a frame finishes its I/O or an evicted page finishes its write-back. */
+  std::condition_variable io_cv_;
+  /** The page cleaner thread, or nullptr if it is not running. */
+  std::thread *cleaner_thread_{nullptr};
+  /** Wakes up the page cleaner early, or tells it to stop. */
+  std::condition_variable cleaner_cv_;
+  /** Set under the latch to make the page cleaner exit. */
+  bool cleaner_stop_{false};
+  size_t cleaner_low_watermark_{0};
+  size_t cleaner_high_watermark_{0};
 
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
@@ -170,6 +243,13 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto AllocatePage() -> page_id_t;
 
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
+   * validate input data and ensure that a parallel BPM is routing requests to the correct BPI
+   * @param page_id
+   */
+  void ValidatePageId(page_id_t page_id) const;
+
   /**
    * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
    * @param page_id id of the page to deallocate
@@ -178,6 +258,76 @@ class BufferPoolManagerInstance : public BufferPoolManager {
     // This is a no-nop right now without a more complex data structure to track deallocated pages
   }
 
-  // TODO(student): You may add additional private members and helper functions
+  /**
+   * @brief Take a frame from the free list, or evict one from the replacer. Caller should acquire the latch.
+   *
+   * The evicted page is removed from the page table. If it was dirty, it is recorded in evicting_pages_ and its id is
+   * returned through victim_page_id; the caller must write it back (after dropping the latch) and then call
+   * FinishWriteBack().
+   *
+   * @param[out] frame_id the acquired frame
+   * @param[out] victim_page_id the dirty page that still needs writing back, or INVALID_PAGE_ID
+   * @param scan_only only evict from the replacer's cold region
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id, page_id_t *victim_page_id, bool scan_only = false) -> bool;
+
+  /**
+   * @brief Hand a page read or write to the disk scheduler. The caller must keep data valid until the future is ready.
+   * A write first waits for the log records the page depends on, so it must not be called with the latch held.
+   * @return a future that becomes ready once the I/O has completed
+   */
+  auto ScheduleIo(bool is_write, char *data, page_id_t page_id) -> std::future<bool>;
+
+  /** @brief Main loop of the page cleaner thread. */
+  void RunPageCleaner();
+
+  /**
+   * @brief Pick the dirty frames the page cleaner should write back in this round and pin them for the write.
+   * Caller should acquire the latch.
+   */
+  auto CollectFramesToClean() -> std::vector<frame_id_t>;
+
+  /**
+   * @brief Pin a resident frame and clear its dirty flag before writing it back without the latch. Caller should
+   * acquire the latch.
+   */
+  void PinForWriteBack(frame_id_t frame_id);
+
+  /** @brief Issue the writes of all the given frames at once and wait for them. Called without the latch. */
+  void WriteBackFrames(const std::vector<frame_id_t> &frames);
+
+  /** @brief Undo PinForWriteBack() for every frame. Caller should acquire the latch. */
+  void UnpinAfterWriteBack(const std::vector<frame_id_t> &frames);
+
+  /** @brief Wake up the threads waiting for a victim page whose write-back has completed. */
+  void FinishWriteBack(page_id_t victim_page_id);
+
+  /**
+   * @brief Make sure the log records that a page image depends on are on disk before the image is written (WAL).
+   * Called without the latch held, as it may wait for the log to be flushed.
+   * @param data the page image about to be written
+   */
+  void FlushLogForPage(const char *data);
+
+  /** @brief Start the recovery LSN of a frame that is being pinned, if it is clean. Caller should acquire the latch. */
+  void TrackRecLSN(frame_id_t frame_id) {
+    if (rec_lsn_[frame_id] == INVALID_LSN && log_manager_ != nullptr) {
+      rec_lsn_[frame_id] = log_manager_->GetNextLSN();
+    }
+  }
+
+  /** @brief Clear the recovery LSN of a frame that is now clean and unpinned. Caller should acquire the latch. */
+  void ReleaseRecLSN(frame_id_t frame_id) {
+    if (pages_[frame_id].GetPinCount() == 0 && !pages_[frame_id].IsDirty()) {
+      rec_lsn_[frame_id] = INVALID_LSN;
+    }
+  }
+
+  /** @brief Clear the I/O state of a frame and wake up the threads waiting on it. */
+  void FinishFrameIo(frame_id_t frame_id);
+
+  /** @brief Complete a read-ahead: clear the I/O state of the frame and let the replacer evict it again. */
+  void FinishPrefetch(frame_id_t frame_id);
 };
 }  // namespace bustub
@@ -13,10 +13,7 @@
 #pragma once
 
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <queue>
-#include <unordered_map>
 #include <vector>
 
 #include "common/config.h"
@@ -24,6 +21,12 @@
 
 namespace bustub {
 
+/**
+ * How a page is being accessed, as a hint to the replacer. A Scan access comes from a sequential scan that will most
+ * likely not touch the page again, so it must not make the page look hot.
+ */
+enum class AccessType { Unknown = 0, Lookup, Scan, Index };
+
 /**
  * LRUKReplacer implements the LRU-k replacement policy.
  *
@@ -34,6 +37,13 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * All bookkeeping lives in arrays indexed by frame id that are sized once in the constructor, and evictable frames
+ * are kept in indexed binary heaps, so Evict, RecordAccess, SetEvictable and Remove run in O(log n) without
+ * allocating.
+ *
+ * Frames that only sequential scans have touched form a cold region that is evicted first, in LRU order, so a large
+ * scan recycles its own frames instead of pushing out the hot set.
  */
 class LRUKReplacer {
  public:
@@ -69,10 +79,10 @@ class LRUKReplacer {
    * access history.
    *
    * @param[out] frame_id id of frame that is evicted.
+   * @param scan_only only evict a frame of the cold region, i.e. one that only scans have accessed
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Judge(frame_id_t s, frame_id_t t) -> bool;
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id, bool scan_only = false) -> bool;
 
   /**
    * TODO(P1): Add implementation
@@ -83,9 +93,13 @@ class LRUKReplacer {
    * If frame id is invalid (ie. larger than replacer_size_), throw an exception. You can
    * also use BUSTUB_ASSERT to abort the process if frame id is invalid.
    *
+   * A Scan access puts a frame that no other access has touched into the cold region, and does not count as an
+   * access for any other frame. Any other access moves a frame out of the cold region.
+   *
    * @param frame_id id of frame that received a new access.
+   * @param access_type type of access that was received.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
 
   /**
    * TODO(P1): Add implementation
@@ -125,6 +139,16 @@ class LRUKReplacer {
    */
   void Remove(frame_id_t frame_id);
 
+  /**
+   * @brief Peek at the frames Evict() would pick next, without evicting them.
+   *
+   * Walks the heaps best-first, so it costs O(n log n) regardless of how many frames are evictable.
+   *
+   * @param n the maximum number of frames to return
+   * @return up to n evictable frames, in the order they would be evicted
+   */
+  auto EvictionCandidates(size_t n) -> std::vector<frame_id_t>;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -135,17 +159,63 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
+  /** Marks a frame that is not in any heap. */
+  static constexpr size_t INVALID_HEAP_POS = std::numeric_limits<size_t>::max();
+
+  /** @return the oldest access timestamp kept for the frame, i.e. its first access or its k-th most recent one */
+  auto EarliestAccess(frame_id_t frame_id) const -> size_t { return history_[frame_id * k_ + history_head_[frame_id]]; }
+
+  /** @return the heap an evictable frame belongs to: the cold region, or whether it has been accessed k times yet */
+  auto HeapOf(frame_id_t frame_id) -> std::vector<frame_id_t> & {
+    if (scan_only_[frame_id]) {
+      return scan_heap_;
+    }
+    return history_size_[frame_id] < k_ ? history_heap_ : cache_heap_;
+  }
+
+  /** Forget the access history of a frame that has already been taken out of its heap. */
+  void ResetHistory(frame_id_t frame_id) {
+    history_head_[frame_id] = 0;
+    history_size_[frame_id] = 0;
+    scan_only_[frame_id] = false;
+  }
+
+  /** Append up to n frames of the heap to out, in heap order. */
+  void HeapPeek(const std::vector<frame_id_t> &heap, size_t n, std::vector<frame_id_t> *out) const;
+  void HeapPush(std::vector<frame_id_t> &heap, frame_id_t frame_id);
+  void HeapErase(std::vector<frame_id_t> &heap, frame_id_t frame_id);
+  void SiftUp(std::vector<frame_id_t> &heap, size_t pos);
+  void SiftDown(std::vector<frame_id_t> &heap, size_t pos);
+  /** Put the frame at the given position of the heap and remember where it is. */
+  void HeapPlace(std::vector<frame_id_t> &heap, size_t pos, frame_id_t frame_id) {
+    heap[pos] = frame_id;
+    heap_pos_[frame_id] = pos;
+  }
+
   size_t current_timestamp_{0};
   size_t curr_size_{0};
   size_t replacer_size_;
   size_t k_;
-  struct Frameinfo {
-    bool evictable_{false};
-    std::queue<size_t> time_;
-  };
-  std::unordered_map<frame_id_t, struct Frameinfo> hash_;
+  /** The last k access timestamps of every frame, stored as a ring buffer of k slots per frame. */
+  std::vector<size_t> history_;
+  /** Slot of the oldest timestamp in each frame's ring buffer. */
+  std::vector<size_t> history_head_;
+  /** Number of timestamps recorded for each frame, at most k. A frame with none is not tracked by the replacer. */
+  std::vector<size_t> history_size_;
+  std::vector<bool> evictable_;
+  /** True for a frame that only Scan accesses have touched since it was loaded. */
+  std::vector<bool> scan_only_;
+  /** Position of each evictable frame in its heap, or INVALID_HEAP_POS. */
+  std::vector<size_t> heap_pos_;
+  /**
+   * Evictable frames with fewer than k accesses, ordered by their first access. They all have +inf backward
+   * k-distance, so they are evicted before any frame of cache_heap_.
+   */
+  std::vector<frame_id_t> history_heap_;
+  /** Evictable frames with k accesses, ordered by their k-th most recent access, i.e. by backward k-distance. */
+  std::vector<frame_id_t> cache_heap_;
+  /** Evictable frames of the cold region, ordered by their last scan access. They are evicted before all others. */
+  std::vector<frame_id_t> scan_heap_;
   std::mutex latch_;
 };
 
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several BufferPoolManagerInstances. Every instance owns its
+ * own frames, page table, free list, replacer and latch, and a page always lives in the instance selected by
+ * page_id % num_instances, so threads working on different pages rarely contend on the same latch.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of each instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override = default;
+
+  /** @return size of the buffer pool, i.e. the number of frames over all instances */
+  auto GetPoolSize() -> size_t override { return num_instances_ * pool_size_; }
+
+  /** @return the number of BufferPoolManagerInstances */
+  auto GetNumInstances() const -> size_t { return num_instances_; }
+
+  /** Starts the page cleaner of every instance; the watermarks apply to each instance separately. */
+  void StartPageCleaner(size_t low_watermark, size_t high_watermark) override;
+
+  /** Stops the page cleaner of every instance. */
+  void StopPageCleaner() override;
+
+  /** Reads a page ahead in the instance responsible for it. */
+  void PrefetchPage(page_id_t page_id) override;
+
+  /** @return the dirty page tables of all instances, merged */
+  auto GetDirtyPageTable() -> std::unordered_map<page_id_t, lsn_t> override;
+
+  /** @return the BufferPoolManagerInstance with the given index */
+  auto GetInstance(size_t instance_index) -> BufferPoolManagerInstance * {
+    return instances_[instance_index].get();
+  }
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @param access_type type of access to the page
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id, AccessType access_type) -> Page * override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried in round robin order, starting from the instance
+   * after the one that served the previous call, until one of them has a frame to spare.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** Number of BufferPoolManagerInstances. */
+  const size_t num_instances_;
+  /** Number of frames in each BufferPoolManagerInstance. */
+  const size_t pool_size_;
+  /** The instance NewPgImp() tries first. */
+  std::atomic<size_t> next_instance_{0};
+  /** The shards of the buffer pool. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+};
+
+}  // namespace bustub
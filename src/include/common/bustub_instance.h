@@ -213,9 +213,23 @@ class BustubInstance {
   auto MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext>;
 
  public:
-  explicit BustubInstance(const std::string &db_file_name);
+  /**
+   * @param db_file_name the database file
+   * @param buffer_pool_instances number of buffer pool shards; more than one creates a ParallelBufferPoolManager
+   * @param page_size size of a data page in bytes, between DEFAULT_BUSTUB_PAGE_SIZE and MAX_BUSTUB_PAGE_SIZE
+   * @param buffer_pool_size number of frames in each buffer pool shard
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t buffer_pool_instances = 1,
+                          int page_size = DEFAULT_BUSTUB_PAGE_SIZE, size_t buffer_pool_size = BUFFER_POOL_SIZE);
 
-  BustubInstance();
+  /**
+   * Create an in-memory BusTub instance.
+   * @param buffer_pool_instances number of buffer pool shards; more than one creates a ParallelBufferPoolManager
+   * @param page_size size of a data page in bytes, between DEFAULT_BUSTUB_PAGE_SIZE and MAX_BUSTUB_PAGE_SIZE
+   * @param buffer_pool_size number of frames in each buffer pool shard
+   */
+  explicit BustubInstance(size_t buffer_pool_instances = 1, int page_size = DEFAULT_BUSTUB_PAGE_SIZE,
+                          size_t buffer_pool_size = 128);
 
   ~BustubInstance();
 
@@ -271,6 +285,12 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return The bytes that a hash join may keep in memory, see `SET hash_join_memory_budget` */
+  auto GetHashJoinMemoryBudget() -> size_t {
+    auto variable = GetSessionVariable("hash_join_memory_budget");
+    return variable.empty() ? HASH_JOIN_MEMORY_BUDGET : std::stoull(variable);
+  }
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
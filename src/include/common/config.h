@@ -27,15 +27,36 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running page cleaner looks for dirty pages near the eviction end every PAGE_CLEANER_INTERVAL. */
+extern std::chrono::milliseconds page_cleaner_interval;
+
+/**
+ * Size of a data page in bytes. Every page layout, and the disk offsets, are derived from it, so it must be set
+ * (see BustubInstance) before the first page is allocated and must not change afterwards.
+ */
+extern int bustub_page_size;
+
 static constexpr int INVALID_PAGE_ID = -1;                                           // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                            // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                               // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                             // the header page id
-static constexpr int BUSTUB_PAGE_SIZE = 134;                                        // size of a data page in byte
-static constexpr int BUFFER_POOL_SIZE = 528;                                          // size of buffer pool
-static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
+static constexpr int DEFAULT_BUSTUB_PAGE_SIZE = 134;                                 // default (minimum) page size
+static constexpr int MAX_BUSTUB_PAGE_SIZE = 16384;                                   // largest page size in byte
+static constexpr int BUFFER_POOL_SIZE = 528;                                         // default size of buffer pool
+static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * DEFAULT_BUSTUB_PAGE_SIZE);  // size of log buffer
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int DISK_SCHEDULER_WORKERS = 4;  // number of I/O threads per disk scheduler
+static constexpr int PAGE_CLEANER_LOW_WATERMARK = 10;   // % of frames kept clean ahead of eviction, at least
+static constexpr int PAGE_CLEANER_HIGH_WATERMARK = 25;  // % of frames the page cleaner cleans up to
+static constexpr int TABLE_SCAN_READ_AHEAD = 4;         // pages a sequential scan reads ahead of its position
+static constexpr int RECOVERY_REDO_WORKERS = 4;         // number of threads that replay the log during redo
+static constexpr double BULK_LOAD_FILL_FACTOR = 0.9;    // share of a b+ tree node that an index build fills
+static constexpr int INDEX_JOIN_BATCH_SIZE = 128;       // outer tuples an index join looks up in one pass
+static constexpr int HASH_JOIN_PARTITION_SIZE = 4096;   // build tuples per partition of a hash join's table
+static constexpr size_t HASH_JOIN_MEMORY_BUDGET = 64 << 20;  // bytes a hash join keeps in memory before spilling
+static constexpr int HASH_JOIN_SPILL_FANOUT = 16;       // partitions a hash join splits its inputs into to spill
+static constexpr size_t EXECUTION_BATCH_SIZE = 1024;    // tuples an executor yields per NextBatch() call
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
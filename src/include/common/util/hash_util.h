@@ -49,6 +49,20 @@ class HashUtil {
     return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR;
   }
 
+  /**
+   * HashBytes() leaves the top bits of small keys zero. Mixing spreads every input bit over the whole hash, so that a
+   * few of its bits, as used to pick a partition, are as good as any others.
+   */
+  static inline auto MixHash(hash_t hash) -> hash_t {
+    // The 64-bit finalizer of MurmurHash3.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
   template <typename T>
   static inline auto Hash(const T *ptr) -> hash_t {
     return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>  // NOLINT
 #include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -56,6 +57,12 @@ class TransactionManager {
    */
   void Abort(Transaction *txn);
 
+  /**
+   * The active transaction table, for checkpoints. Transactions are only tracked while logging is enabled.
+   * @return every transaction that has neither committed nor aborted, with the LSN of its BEGIN record
+   */
+  auto GetActiveTransactionTable() -> std::unordered_map<txn_id_t, lsn_t>;
+
   /**
    * Global list of running transactions
    */
@@ -134,12 +141,20 @@ class TransactionManager {
     }
   }
 
+  /** Remove a committed or aborted transaction from the active transaction table. */
+  void EndTransaction(Transaction *txn);
+
   std::atomic<txn_id_t> next_txn_id_{0};
   LockManager *lock_manager_ __attribute__((__unused__));
   LogManager *log_manager_ __attribute__((__unused__));
 
   /** The global transaction latch is used for checkpointing. */
   ReaderWriterLatch global_txn_latch_;
+
+  /** Protects active_txn_. A transaction enters it under the same latch as it appends its BEGIN record. */
+  std::mutex active_txn_latch_;
+  /** Running transactions and the LSNs of their BEGIN records. */
+  std::unordered_map<txn_id_t, lsn_t> active_txn_;
 };
 
 }  // namespace bustub
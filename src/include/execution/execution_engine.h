@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -21,6 +22,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 #include "myapi/process_record_context.h"
 
@@ -79,18 +81,30 @@ class ExecutionEngine {
 
  private:
   /**
-   * Poll the executor until exhausted, or exception escapes.
+   * Poll the executor until exhausted, or exception escapes. The tuples are pulled a batch at a time, unless the
+   * execution is traced: the tuples recorded for every plan node are then exactly those the query consumed.
    * @param executor The root executor
    * @param plan The plan to execute
    * @param result_set The tuple result set
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set, ProcessRecordContext *ptx) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid, ptx)) {
+    if (ptx != nullptr) {
+      RID rid{};
+      Tuple tuple{};
+      while (executor->Next(&tuple, &rid, ptx)) {
+        if (result_set != nullptr) {
+          result_set->push_back(tuple);
+        }
+      }
+      return;
+    }
+    TupleBatch batch;
+    while (executor->NextBatch(&batch, ptx)) {
       if (result_set != nullptr) {
-        result_set->push_back(tuple);
+        for (size_t i = 0; i < batch.Size(); i++) {
+          result_set->push_back(std::move(batch.GetTuple(i)));
+        }
       }
     }
   }
@@ -33,10 +33,16 @@ class ExecutorContext {
    * @param bpm The buffer pool manager that the executor uses
    * @param txn_mgr The transaction manager that the executor uses
    * @param lock_mgr The lock manager that the executor uses
+   * @param hash_join_memory_budget The bytes that a hash join may keep in memory before it spills to disk
    */
   ExecutorContext(Transaction *transaction, Catalog *catalog, BufferPoolManager *bpm, TransactionManager *txn_mgr,
-                  LockManager *lock_mgr)
-      : transaction_(transaction), catalog_{catalog}, bpm_{bpm}, txn_mgr_(txn_mgr), lock_mgr_(lock_mgr) {}
+                  LockManager *lock_mgr, size_t hash_join_memory_budget = HASH_JOIN_MEMORY_BUDGET)
+      : transaction_(transaction),
+        catalog_{catalog},
+        bpm_{bpm},
+        txn_mgr_(txn_mgr),
+        lock_mgr_(lock_mgr),
+        hash_join_memory_budget_(hash_join_memory_budget) {}
 
   ~ExecutorContext() = default;
 
@@ -60,6 +66,9 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return the bytes that a hash join may keep in memory before it spills to disk */
+  auto GetHashJoinMemoryBudget() const -> size_t { return hash_join_memory_budget_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +80,8 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The bytes that a hash join may keep in memory before it spills to disk */
+  size_t hash_join_memory_budget_;
 };
 
 }  // namespace bustub
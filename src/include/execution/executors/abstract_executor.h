@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <utility>
+
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 #include "myapi/process_record_context.h"
 
@@ -21,6 +24,9 @@ namespace bustub {
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors can also yield a batch of tuples at a time with NextBatch(). By default it collects the tuples of Next();
+ * executors that produce many tuples override it, and may in turn implement Next() with NextFromBatch().
  */
 class AbstractExecutor {
  public:
@@ -47,6 +53,22 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. A caller uses either Next() or NextBatch() on an executor, not
+   * both.
+   * @param[out] batch Cleared, then filled with up to EXECUTION_BATCH_SIZE tuples
+   * @return `true` if any tuple was produced, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool {
+    batch->Clear();
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid, ptx)) {
+      batch->Append(std::move(tuple), rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -54,7 +76,32 @@ class AbstractExecutor {
   auto GetExecutorContext() -> ExecutorContext * { return exec_ctx_; }
 
  protected:
+  /** Next() for executors that override NextBatch(): yield the tuples of its batches one by one. */
+  auto NextFromBatch(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool {
+    if (adapter_pos_ == adapter_batch_.Size()) {
+      adapter_pos_ = 0;
+      if (!NextBatch(&adapter_batch_, ptx)) {
+        return false;
+      }
+    }
+    *tuple = std::move(adapter_batch_.GetTuple(adapter_pos_));
+    *rid = adapter_batch_.GetRid(adapter_pos_);
+    adapter_pos_++;
+    return true;
+  }
+
+  /** Drop the tuples that NextFromBatch() has not yielded yet; to be called by Init(). */
+  void ResetBatchAdapter() {
+    adapter_batch_.Clear();
+    adapter_pos_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The batch that NextFromBatch() yields tuples from, and its next tuple */
+  TupleBatch adapter_batch_;
+  size_t adapter_pos_{0};
 };
 }  // namespace bustub
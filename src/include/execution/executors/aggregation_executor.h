@@ -116,10 +116,11 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    auto it = ht_.find(agg_key);
+    if (it == ht_.end()) {
+      it = ht_.emplace(agg_key, GenerateInitialAggregateValue()).first;
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
+    CombineAggregateValues(&it->second, agg_val);
   }
 
   /**
@@ -48,6 +48,9 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
+  /** Yield the next batch of tuples that satisfy the predicate, filtering a batch of the child in place. */
+  auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool override;
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
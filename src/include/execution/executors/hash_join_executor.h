@@ -12,18 +12,138 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "buffer/buffer_pool_manager.h"
+#include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/page/tmp_tuple_page.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * The hash table of a hash join, built once on all tuples of one input and then probed with the keys of the other.
+ *
+ * The tuples and their keys are kept in arrays. An open-addressing table maps the hash of a key to the first tuple
+ * with that hash, and the tuples with the same hash are chained in the order they were inserted. Once there are more
+ * than HASH_JOIN_PARTITION_SIZE tuples, they are radix-partitioned on the top bits of the hash and every partition
+ * gets its own small table, so that a probe stays within a cache-sized piece of memory.
+ */
+class JoinHashTable {
+ public:
+  /** Marks the end of a chain and an empty slot. */
+  static constexpr uint32_t NO_ENTRY = UINT32_MAX;
+
+  /** Remove all tuples. */
+  void Clear();
+
+  /**
+   * Add a tuple; it can only be found after Build().
+   * @param tuple The tuple
+   * @param key The join key of the tuple, which must not contain NULL
+   * @param hash The hash of the key, see HashKey()
+   */
+  void Insert(Tuple &&tuple, std::vector<Value> &&key, hash_t hash);
+
+  /** Partition the inserted tuples and build the table over them. */
+  void Build();
+
+  /** @return The first entry with the given key, or NO_ENTRY */
+  auto Find(const std::vector<Value> &key, hash_t hash) const -> uint32_t;
+
+  /** @return The entry after `entry` with the same key, or NO_ENTRY */
+  auto FindNext(uint32_t entry, const std::vector<Value> &key) const -> uint32_t;
+
+  /** @return The tuple of an entry; the entries are numbered from 0 to Size() - 1 */
+  auto GetTuple(uint32_t entry) const -> const Tuple & { return tuples_[entry]; }
+
+  /** @return The number of tuples */
+  auto Size() const -> size_t { return tuples_.size(); }
+
+  /** @return The hash of a join key */
+  static auto HashKey(const std::vector<Value> &key) -> hash_t;
+
+  /** @return Roughly the bytes that a tuple takes up in the table */
+  static auto EntrySize(const Tuple &tuple, size_t key_size) -> size_t {
+    return sizeof(Tuple) + tuple.GetLength() + key_size * sizeof(Value) + sizeof(hash_t) + sizeof(uint32_t) +
+           2 * sizeof(Slot);
+  }
+
+ private:
+  /** A slot of the open-addressing table */
+  struct Slot {
+    hash_t hash_{0};
+    uint32_t head_{NO_ENTRY};
+  };
+
+  /** @return Whether the key of an entry equals the given key */
+  auto KeyEquals(uint32_t entry, const std::vector<Value> &key) const -> bool;
+
+  /** @return The partition that a hash belongs to */
+  auto PartitionOf(hash_t hash) const -> size_t { return radix_bits_ == 0 ? 0 : hash >> (64 - radix_bits_); }
+
+  /** The tuples, grouped by partition after Build() */
+  std::vector<Tuple> tuples_;
+  /** The join keys of the tuples, key_size_ values each */
+  std::vector<Value> keys_;
+  size_t key_size_{0};
+  /** The hashes of the join keys */
+  std::vector<hash_t> hashes_;
+  /** The next entry with the same hash */
+  std::vector<uint32_t> next_;
+  /** The slots of all partitions */
+  std::vector<Slot> slots_;
+  /** Where the slots of each partition start; the slot count of a partition is a power of two */
+  std::vector<size_t> slot_offsets_;
+  /** The number of top hash bits that select a partition */
+  size_t radix_bits_{0};
+};
+
+/**
+ * Tuples written to temporary pages through the buffer pool and then read back once, a page at a time. The pages are
+ * deleted once they are read, or when the file is destroyed.
+ */
+class TmpTupleFile {
+ public:
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /** Append a tuple to the last page, or to a new page if it is full. */
+  void Append(const Tuple &tuple);
+
+  /**
+   * Read the tuples of the next page, in the order they were appended.
+   * @return `false` if all pages have been read
+   */
+  auto ReadPage(std::vector<Tuple> *tuples) -> bool;
+
+ private:
+  BufferPoolManager *bpm_;
+  /** The pages of the file, in the order they were written */
+  std::vector<page_id_t> page_ids_;
+  /** The page that tuples are appended to, which stays pinned until it is full */
+  TmpTuplePage *last_page_{nullptr};
+  /** The next page to read */
+  size_t next_read_{0};
+};
+
+/**
+ * HashJoinExecutor executes an equi-JOIN on two tables by building a hash table on one input and streaming the other
+ * input through it.
+ *
+ * The build input is split into HASH_JOIN_SPILL_FANOUT partitions by the hash of the join key, each with its own
+ * table. When the tables grow beyond the memory budget of the query, the largest partition is written to temporary
+ * pages, together with the build and probe tuples of that partition that follow. The partitions that stay in memory
+ * are joined while the probe input streams by; the spilled partitions are joined one after another once it ends.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -48,12 +168,82 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
+  /** Yield the next batch of tuples from the join, probing with a batch of the probe input at a time. */
+  auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /**
+   * Evaluate a join key on a tuple.
+   * @return `false` if a part of the key is NULL, which matches nothing
+   */
+  static auto MakeKey(const std::vector<AbstractExpressionRef> &exprs, const Tuple &tuple, const Schema &schema,
+                      std::vector<Value> *key) -> bool;
+
+  /** @return The partition of the tuples with this key hash, taken from other bits than JoinHashTable uses */
+  static auto SpillPartitionOf(hash_t hash) -> size_t { return (hash >> 32) % HASH_JOIN_SPILL_FANOUT; }
+
+  /** Add a build tuple to the table of its partition, or to the spill file of a spilled partition. */
+  void AddBuildTuple(Tuple &&tuple, std::vector<Value> *key, size_t memory_budget);
+
+  /** Write the largest partition in memory to temporary pages. @return `false` if all partitions are spilled */
+  auto SpillLargestPartition() -> bool;
+
+  /**
+   * Move on to the next probe tuple, first from the probe input and then from the spilled partitions, and find its
+   * first match.
+   * @return `false` if there are no more probe tuples
+   */
+  auto NextProbeTuple(ProcessRecordContext *ptx) -> bool;
+
+  /** Load the build tuples of the next spilled partition into its table. @return `false` if there is none */
+  auto LoadNextSpilledPartition() -> bool;
+
+  /** Add the join of probe_tuple_ and a build tuple to the batch, or NULLs for the build side if it is `nullptr` */
+  void Emit(const Tuple *build_tuple, TupleBatch *batch, ProcessRecordContext *ptx);
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The input the hash table is built on */
+  std::unique_ptr<AbstractExecutor> build_executor_;
+  /** The input that probes the hash table */
+  std::unique_ptr<AbstractExecutor> probe_executor_;
+  /** The join key expressions of the build and the probe input */
+  const std::vector<AbstractExpressionRef> *build_key_exprs_;
+  const std::vector<AbstractExpressionRef> *probe_key_exprs_;
+  /** The hash tables over the partitions of the build input */
+  std::vector<JoinHashTable> partitions_;
+  /** The bytes that each partition takes up in memory */
+  std::vector<size_t> partition_bytes_;
+  /** The bytes that all partitions take up in memory */
+  size_t memory_used_{0};
+  /** The build and probe tuples of each spilled partition, `nullptr` for the partitions in memory */
+  std::vector<std::unique_ptr<TmpTupleFile>> build_spills_;
+  std::vector<std::unique_ptr<TmpTupleFile>> probe_spills_;
+  /** Whether probe tuples still come from the probe input rather than from the spilled partitions */
+  bool reading_probe_input_{true};
+  /** The current batch of the probe input, and the next tuple to take from it */
+  TupleBatch probe_batch_;
+  size_t probe_batch_pos_{0};
+  /** The next partition to look at for spilled tuples */
+  size_t next_spilled_partition_{0};
+  /** The probe tuples read from a page of a spilled partition, and the next one to join */
+  std::vector<Tuple> probe_page_;
+  size_t probe_page_pos_{0};
+  /** The current probe tuple, its key, and the partition it belongs to */
+  Tuple probe_tuple_;
+  std::vector<Value> probe_key_;
+  size_t probe_partition_{HASH_JOIN_SPILL_FANOUT};
+  /** Whether probe_tuple_ still has matches to yield */
+  bool has_probe_tuple_{false};
+  /** Whether probe_tuple_ found a match */
+  bool probe_matched_{false};
+  /** The next build entry that matches probe_tuple_ */
+  uint32_t match_{JoinHashTable::NO_ENTRY};
+  /** The values of an output tuple, kept to reuse their buffer */
+  std::vector<Value> values_;
 };
 
 }  // namespace bustub
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <memory>
+#include <variant>
 #include <vector>
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/index_scan_plan.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -42,10 +44,27 @@ class IndexScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
  private:
+  /** An iterator over the index, typed by the key width; monostate once the scan is done. */
+  using IteratorVariant =
+      std::variant<std::monostate, BPlusTreeIndexIteratorForKeySize<4>, BPlusTreeIndexIteratorForKeySize<8>,
+                   BPlusTreeIndexIteratorForKeySize<16>, BPlusTreeIndexIteratorForKeySize<32>,
+                   BPlusTreeIndexIteratorForKeySize<64>>;
+
+  /** @return -1, 0 or 1 as the first bound.size() key columns compare to bound */
+  auto ComparePrefix(const std::vector<Value> &key_values, const std::vector<Value> &bound) const -> int;
+
+  /**
+   * Moves the iterator past the next entry in range.
+   * @param[out] tuple set to the tuple built from the entry if the scan is index-only
+   * @return false if no entry in range is left
+   */
+  template <size_t KeySize>
+  auto NextEntry(BPlusTreeIndexIteratorForKeySize<KeySize> *iterator, RID *rid, Tuple *tuple) -> bool;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
-  BPlusTreeIndexForOneIntegerColumn *index_;
-  std::unique_ptr<BPlusTreeIndexIteratorForOneIntegerColumn> iterator_;
+  IndexInfo *index_info_;
+  IteratorVariant iterator_;
   TableHeap *table_heap_;
 };
 }  // namespace bustub
@@ -54,5 +54,22 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool is_ineer_{false};
   IndexInfo *index_info_;
   TableInfo *table_info_;
+  /** Whether index keys may be string prefixes, so that matches have to be checked on the inner tuple. */
+  bool key_is_lossy_{false};
+  /**
+   * Reads the next batch of outer tuples, looks all of them up in the index at once and fetches the matching inner
+   * tuples in RID order, so that each inner table page is visited once per batch.
+   * @return false if the outer side has no tuples left
+   */
+  auto NextBatch(ProcessRecordContext *ptx) -> bool;
+  /** @return the outer tuple's join key in the type of the indexed column, NULL if it cannot match anything */
+  auto ProbeValue(const Tuple &left_tuple) const -> Value;
+
+  /** The outer tuples of the current batch and, for each of them, the inner tuples it joins with. */
+  std::vector<Tuple> left_tuples_;
+  std::vector<std::vector<Tuple>> right_tuples_;
+  /** The next outer tuple of the batch and the next of its inner tuples to emit. */
+  size_t next_left_{0};
+  size_t next_right_{0};
 };
 }  // namespace bustub
@@ -50,24 +50,34 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
+  /** Yield the next batch of tuples from the join, joining a batch of left tuples at a time. */
+  auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool override;
+
   /** @return The output schema for the insert */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
-  auto InnerJoin(const Schema &schema, Tuple *tuple, ProcessRecordContext *ptx) -> bool;
-  auto LeftJoin(const Schema &schema, Tuple *tuple, ProcessRecordContext *ptx) -> bool;
+  /** Add the join of a left tuple and a right tuple to the batch, or NULLs for the right side if it is `nullptr`. */
+  void Emit(const Tuple &left_tuple, const Tuple *right_tuple, TupleBatch *batch, ProcessRecordContext *ptx);
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
-  bool is_ineer_{false};
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
+  /** All tuples of the right input */
   std::vector<Tuple> right_tuples_;
-  uint64_t index_{0};
-  Tuple left_tuple_;
-  RID left_rid_;
+  /** The current batch of left tuples, the left tuple being joined, and the next right tuple to join it with */
+  TupleBatch left_batch_;
+  size_t left_pos_{0};
+  size_t right_pos_{0};
+  /** Whether the left tuple being joined has found a match */
+  bool left_matched_{false};
+  /** Whether the left input has no more tuples */
+  bool left_done_{false};
+  /** The values of an output tuple, kept to reuse their buffer */
+  std::vector<Value> values_;
   Schema left_schema_;
   Schema right_schema_;
-  bool is_match_{true};
 };
 
 }  // namespace bustub
@@ -47,6 +47,9 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
+  /** Yield the projections of the next batch of child tuples. */
+  auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +59,8 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The batch of child tuples that NextBatch() projects */
+  TupleBatch child_batch_;
 };
 }  // namespace bustub
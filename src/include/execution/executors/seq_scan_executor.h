@@ -44,6 +44,12 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid, ProcessRecordContext *ptx) -> bool override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan. Under READ_COMMITTED a row is unlocked as soon as it is
+   * copied into the batch.
+   */
+  auto NextBatch(TupleBatch *batch, ProcessRecordContext *ptx) -> bool override;
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -24,6 +24,9 @@ namespace bustub {
 
 /**
  * Hash join performs a JOIN operation with a hash table.
+ *
+ * The join condition is an AND of equalities, the i-th left key expression equal to the i-th right key expression.
+ * The hash table is built on the right input unless `build_left_` is set, which only an INNER join allows.
  */
 class HashJoinPlanNode : public AbstractPlanNode {
  public:
@@ -31,25 +34,27 @@ class HashJoinPlanNode : public AbstractPlanNode {
    * Construct a new HashJoinPlanNode instance.
    * @param output_schema The output schema for the JOIN
    * @param children The child plans from which tuples are obtained
-   * @param left_key_expression The expression for the left JOIN key
-   * @param right_key_expression The expression for the right JOIN key
+   * @param left_key_expressions The expressions for the left JOIN keys
+   * @param right_key_expressions The expressions for the right JOIN keys
    */
   HashJoinPlanNode(SchemaRef output_schema, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
-                   AbstractExpressionRef left_key_expression, AbstractExpressionRef right_key_expression,
-                   JoinType join_type)
+                   std::vector<AbstractExpressionRef> left_key_expressions,
+                   std::vector<AbstractExpressionRef> right_key_expressions, JoinType join_type)
       : AbstractPlanNode(std::move(output_schema), {std::move(left), std::move(right)}),
-        left_key_expression_{std::move(left_key_expression)},
-        right_key_expression_{std::move(right_key_expression)},
+        left_key_expressions_{std::move(left_key_expressions)},
+        right_key_expressions_{std::move(right_key_expressions)},
         join_type_(join_type) {}
 
   /** @return The type of the plan node */
   auto GetType() const -> PlanType override { return PlanType::HashJoin; }
 
-  /** @return The expression to compute the left join key */
-  auto LeftJoinKeyExpression() const -> const AbstractExpression & { return *left_key_expression_; }
+  /** @return The expressions to compute the left join keys */
+  auto LeftJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & { return left_key_expressions_; }
 
-  /** @return The expression to compute the right join key */
-  auto RightJoinKeyExpression() const -> const AbstractExpression & { return *right_key_expression_; }
+  /** @return The expressions to compute the right join keys */
+  auto RightJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & {
+    return right_key_expressions_;
+  }
 
   /** @return The left plan node of the hash join */
   auto GetLeftPlan() const -> AbstractPlanNodeRef {
@@ -68,24 +73,21 @@ class HashJoinPlanNode : public AbstractPlanNode {
 
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(HashJoinPlanNode);
 
-  /** The expression to compute the left JOIN key */
-  AbstractExpressionRef left_key_expression_;
-  /** The expression to compute the right JOIN key */
-  AbstractExpressionRef right_key_expression_;
+  /** The expressions to compute the left JOIN keys */
+  std::vector<AbstractExpressionRef> left_key_expressions_;
+  /** The expressions to compute the right JOIN keys */
+  std::vector<AbstractExpressionRef> right_key_expressions_;
 
   /** The join type */
   JoinType join_type_;
 
+  /** Whether the hash table is built on the left input and the right input probes it */
+  bool build_left_{false};
+
  protected:
-  auto PlanNodeToString() const -> std::string override {
-    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expression_,
-                       right_key_expression_);
-  }
-  void PlanNodeToJSON(rapidjson::Value &json_attr, rapidjson_allocator_t &json_alloc) const override {
-    json_attr.AddMember("type",       rapidjson::Value(fmt::format("{}", join_type_).c_str(),             json_alloc), json_alloc);
-    json_attr.AddMember("left_key",   rapidjson::Value(fmt::format("{}", left_key_expression_).c_str(),   json_alloc), json_alloc);
-    json_attr.AddMember("right_key",  rapidjson::Value(fmt::format("{}", right_key_expression_).c_str(),  json_alloc), json_alloc);
-  }
+  auto PlanNodeToString() const -> std::string override;
+
+  void PlanNodeToJSON(rapidjson::Value &, rapidjson_allocator_t &) const override;
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
@@ -22,16 +23,33 @@
 namespace bustub {
 /**
  * IndexScanPlanNode identifies a table that should be scanned with an optional predicate.
+ *
+ * The scan walks the index in key order. It can be restricted to a range of keys: it then seeks to the lower bound
+ * and stops after the upper bound. A bound is a prefix of the key columns, so `(a, b)` can be scanned for `a = 1` or
+ * for `a = 1 AND b > 5`; a point lookup has equal inclusive bounds.
+ *
+ * An index-only scan builds its tuples from the key and included columns of the index entries instead of fetching
+ * them from the table. The other columns of its output are NULL, so it is only planned when nothing reads them.
  */
 class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param lower_bound values of the leading key columns of the smallest key to return, empty to start at the first key
+   * @param lower_inclusive whether keys starting with lower_bound are returned
+   * @param upper_bound values of the leading key columns of the largest key to return, empty to run to the last key
+   * @param upper_inclusive whether keys starting with upper_bound are returned
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid, std::vector<Value> lower_bound = {},
+                    bool lower_inclusive = true, std::vector<Value> upper_bound = {}, bool upper_inclusive = true)
+      : AbstractPlanNode(std::move(output), {}),
+        index_oid_(index_oid),
+        lower_bound_(std::move(lower_bound)),
+        lower_inclusive_(lower_inclusive),
+        upper_bound_(std::move(upper_bound)),
+        upper_inclusive_(upper_inclusive) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,14 +61,55 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The key range to scan; a missing bound leaves that side open. */
+  std::vector<Value> lower_bound_;
+  bool lower_inclusive_;
+  std::vector<Value> upper_bound_;
+  bool upper_inclusive_;
+
+  /** Whether the output is built from the index entries alone, without fetching the table tuples. */
+  bool index_only_{false};
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
+    std::string attrs = fmt::format("index_oid={}", index_oid_);
+    if (!lower_bound_.empty() || !upper_bound_.empty()) {
+      attrs += fmt::format(", range={}", RangeToString());
+    }
+    if (index_only_) {
+      attrs += ", index_only=true";
+    }
+    return fmt::format("IndexScan {{ {} }}", attrs);
   }
   void PlanNodeToJSON(rapidjson::Value &json_attr, rapidjson_allocator_t &json_alloc) const override {
     json_attr.AddMember("index_oid", index_oid_, json_alloc);
+    if (!lower_bound_.empty() || !upper_bound_.empty()) {
+      json_attr.AddMember("range", rapidjson::Value(RangeToString().c_str(), json_alloc), json_alloc);
+    }
+    if (index_only_) {
+      json_attr.AddMember("index_only", true, json_alloc);
+    }
+  }
+
+ private:
+  auto RangeToString() const -> std::string {
+    return fmt::format("{}{}, {}{}", lower_inclusive_ ? "[" : "(", BoundToString(lower_bound_, "-inf"),
+                       BoundToString(upper_bound_, "+inf"), upper_inclusive_ ? "]" : ")");
+  }
+
+  static auto BoundToString(const std::vector<Value> &bound, const char *open) -> std::string {
+    if (bound.empty()) {
+      return open;
+    }
+    if (bound.size() == 1) {
+      return bound[0].ToString();
+    }
+    std::vector<std::string> values;
+    values.reserve(bound.size());
+    for (const auto &value : bound) {
+      values.push_back(value.ToString());
+    }
+    return fmt::format("({})", fmt::join(values, ", "));
   }
 };
 
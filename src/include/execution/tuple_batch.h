@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * A batch of up to EXECUTION_BATCH_SIZE tuples and their RIDs, which an executor hands to its parent in one
+ * NextBatch() call. The buffers are kept when the batch is cleared, so a batch that is refilled over and over only
+ * allocates the tuples themselves.
+ */
+class TupleBatch {
+ public:
+  /** Remove all tuples. */
+  void Clear() {
+    tuples_.clear();
+    rids_.clear();
+  }
+
+  /** Add a tuple at the end. */
+  void Append(Tuple &&tuple, RID rid) {
+    tuples_.push_back(std::move(tuple));
+    rids_.push_back(rid);
+  }
+
+  /** Keep only the first `size` tuples. */
+  void Truncate(size_t size) {
+    tuples_.resize(size);
+    rids_.resize(size);
+  }
+
+  /** Move tuple `from` to position `to`, leaving `from` empty. */
+  void MoveTuple(size_t from, size_t to) {
+    tuples_[to] = std::move(tuples_[from]);
+    rids_[to] = rids_[from];
+  }
+
+  /** @return The number of tuples */
+  auto Size() const -> size_t { return tuples_.size(); }
+
+  /** @return Whether the batch holds no tuple */
+  auto IsEmpty() const -> bool { return tuples_.empty(); }
+
+  /** @return Whether the batch holds EXECUTION_BATCH_SIZE tuples */
+  auto IsFull() const -> bool { return tuples_.size() >= EXECUTION_BATCH_SIZE; }
+
+  auto GetTuple(size_t i) -> Tuple & { return tuples_[i]; }
+  auto GetTuple(size_t i) const -> const Tuple & { return tuples_[i]; }
+  auto GetRid(size_t i) const -> RID { return rids_[i]; }
+
+ private:
+  std::vector<Tuple> tuples_;
+  std::vector<RID> rids_;
+};
+
+}  // namespace bustub
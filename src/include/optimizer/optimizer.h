@@ -45,8 +45,8 @@ class Optimizer {
 
   /**
    * @brief optimize nested loop join into hash join.
-   * In the starter code, we will check NLJs with exactly one equal condition. You can further support optimizing joins
-   * with multiple eq conditions.
+   * The join condition must be an AND of equalities, each between a column of the left and a column of the right
+   * input. An inner join builds its hash table on the input whose table is estimated to be smaller.
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
@@ -80,11 +80,26 @@ class Optimizer {
   /** @brief check if the predicate is true::boolean */
   auto IsPredicateTrue(const AbstractExpression &expr) -> bool;
 
+  /** @brief flatten a tree of ANDs into its conjuncts */
+  static void SplitConjunction(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts);
+
+  /**
+   * @brief turn comparisons between an indexed integer column and constants in a seq scan's predicate into the key
+   * range of an index scan; the comparisons that don't bound the key stay in a filter above it.
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief optimize order by as index scan if there's an index on a table
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief let an index scan build its tuples from the index entries when the projection or aggregation above it only
+   * reads key and included columns, which saves fetching every tuple from its table page.
+   */
+  auto OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
@@ -12,6 +12,9 @@
 
 #pragma once
 
+#include <thread>  // NOLINT
+#include <unordered_map>
+
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/transaction_manager.h"
 #include "recovery/log_manager.h"
@@ -19,7 +22,13 @@
 namespace bustub {
 
 /**
- * CheckpointManager creates consistent checkpoints by blocking all other transactions temporarily.
+ * CheckpointManager takes fuzzy checkpoints, which bound the work of recovery and the size of the log without
+ * blocking transactions.
+ *
+ * BeginCheckpoint takes the dirty page table and starts writing those pages back in the background, one page at a
+ * time. EndCheckpoint waits for the write-back. Then the oldest LSN that recovery still
+ * needs is the smallest of the LSN at which the checkpoint began, the recovery LSNs of the pages that are dirty again
+ * or still, and the BEGIN LSNs of the active transactions; the log before it is released.
  */
 class CheckpointManager {
  public:
@@ -29,15 +38,25 @@ class CheckpointManager {
         log_manager_(log_manager),
         buffer_pool_manager_(buffer_pool_manager) {}
 
-  ~CheckpointManager() = default;
+  ~CheckpointManager();
 
   void BeginCheckpoint();
   void EndCheckpoint();
 
  private:
-  TransactionManager *transaction_manager_ __attribute__((__unused__));
-  LogManager *log_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /** Write back the pages of the dirty page table taken by BeginCheckpoint. Runs on flush_thread_. */
+  void FlushDirtyPages();
+
+  TransactionManager *transaction_manager_;
+  LogManager *log_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+
+  /** The next LSN when the checkpoint began. */
+  lsn_t checkpoint_lsn_{INVALID_LSN};
+  /** The dirty page table when the checkpoint began: page id -> recovery LSN. */
+  std::unordered_map<page_id_t, lsn_t> dirty_pages_;
+  /** Writes back the dirty pages of the running checkpoint, or nullptr if no checkpoint is running. */
+  std::thread *flush_thread_{nullptr};
 };
 
 }  // namespace bustub
@@ -14,8 +14,11 @@
 
 #include <algorithm>
 #include <condition_variable>  // NOLINT
-#include <future>              // NOLINT
-#include <mutex>               // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "recovery/log_record.h"
 #include "storage/disk/disk_manager.h"
@@ -25,6 +28,10 @@ namespace bustub {
 /**
  * LogManager maintains a separate thread that is awakened whenever the log buffer is full or whenever a timeout
  * happens. When the thread is awakened, the log buffer's content is written into the disk log file.
+ *
+ * Records are appended to log_buffer_ under a short latch. The flush thread swaps log_buffer_ with flush_buffer_ and
+ * writes the latter out without holding the latch, so appends go on during the write. A committing transaction only
+ * waits until its commit record is persistent; all commits that wait at the same time share a single log write.
  */
 class LogManager {
  public:
@@ -35,6 +42,7 @@ class LogManager {
   }
 
   ~LogManager() {
+    StopFlushThread();
     delete[] log_buffer_;
     delete[] flush_buffer_;
     log_buffer_ = nullptr;
@@ -46,13 +54,35 @@ class LogManager {
 
   auto AppendLogRecord(LogRecord *log_record) -> lsn_t;
 
+  /**
+   * Block until the log is persistent up to and including the given LSN. This is how a commit and a page write-back
+   * wait for the log (group commit and WAL). An LSN that has not been handed out yet stands for every record appended
+   * so far.
+   * @param lsn the LSN that must reach the disk
+   */
+  void Flush(lsn_t lsn);
+
+  /**
+   * Release the part of the log file that recovery no longer needs. Recovery can only start at the beginning of a log
+   * write, so the log is kept from the start of the write that contains the given LSN. The new start is recorded in
+   * the master record before anything is released.
+   * @param lsn the oldest LSN that recovery still needs
+   */
+  void TruncateLog(lsn_t lsn);
+
   inline auto GetNextLSN() -> lsn_t { return next_lsn_; }
   inline auto GetPersistentLSN() -> lsn_t { return persistent_lsn_; }
   inline void SetPersistentLSN(lsn_t lsn) { persistent_lsn_ = lsn; }
   inline auto GetLogBuffer() -> char * { return log_buffer_; }
 
  private:
-  // TODO(students): you may add your own member variables
+  /**
+   * Swap the buffers, write out the records that were in log_buffer_ and advance the persistent LSN. The latch is
+   * released during the write so that appends go on. Normally only the flush thread calls this; other threads do when
+   * it is not running.
+   * @param lock the caller's lock on latch_
+   */
+  void FlushLogBuffer(std::unique_lock<std::mutex> *lock);
 
   /** The atomic counter which records the next log sequence number. */
   std::atomic<lsn_t> next_lsn_;
@@ -61,14 +91,28 @@ class LogManager {
 
   char *log_buffer_;
   char *flush_buffer_;
+  /** Number of bytes of log_buffer_ in use. */
+  int log_buffer_offset_{0};
+  /** The first LSN and the file offset of every log write that has not been truncated yet, oldest first. */
+  std::deque<std::pair<lsn_t, int>> log_writes_;
 
+  /** Protects the log buffer, the LSN counter and the flush thread state. */
   std::mutex latch_;
 
-  std::thread *flush_thread_ __attribute__((__unused__));
+  std::thread *flush_thread_{nullptr};
+  /** Set when StopFlushThread() asks the flush thread to exit. */
+  bool stop_flush_thread_{false};
+  /** Set when a thread waits for the log to reach the disk, so the flush thread does not wait for the timeout. */
+  bool flush_requested_{false};
+  /** True while flush_buffer_ is being written out without the latch held. */
+  bool flushing_{false};
 
+  /** Wakes up the flush thread. */
   std::condition_variable cv_;
+  /** Signals the threads waiting for a flush to complete. */
+  std::condition_variable flushed_cv_;
 
-  DiskManager *disk_manager_ __attribute__((__unused__));
+  DiskManager *disk_manager_;
 };
 
 }  // namespace bustub
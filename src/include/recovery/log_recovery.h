@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "concurrency/lock_manager.h"
@@ -22,13 +24,27 @@
 
 namespace bustub {
 
+class TablePage;
+
 /**
  * Read log file from disk, redo and undo.
+ *
+ * Redo is a single sequential pass over the log that also performs the analysis: it rebuilds the active transaction
+ * table and the LSN to offset mapping, and hands every page record to a redo worker. Records are partitioned by page
+ * id, so the records of one page are replayed in log order by one worker while different pages are replayed in
+ * parallel. Undo then rolls back the transactions that never committed or aborted, newest record first. Both start
+ * from where the master record of the last checkpoint points to, if there is one.
+ *
+ * Recovery must run before logging is enabled, since neither pass writes log records.
  */
 class LogRecovery {
  public:
-  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager)
-      : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager), offset_(0) {
+  LogRecovery(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager,
+              size_t num_redo_workers = RECOVERY_REDO_WORKERS)
+      : disk_manager_(disk_manager),
+        buffer_pool_manager_(buffer_pool_manager),
+        num_redo_workers_(num_redo_workers),
+        offset_(0) {
     log_buffer_ = new char[LOG_BUFFER_SIZE];
   }
 
@@ -39,18 +55,41 @@ class LogRecovery {
 
   void Redo();
   void Undo();
-  auto DeserializeLogRecord(const char *data, LogRecord *log_record) -> bool;
+  /**
+   * Deserialize a log record.
+   * @param data the serialized log record
+   * @param[out] log_record the deserialized log record
+   * @param size number of bytes that are available at data
+   * @return true if a complete and well-formed log record was read
+   */
+  auto DeserializeLogRecord(const char *data, LogRecord *log_record, int size = LOG_BUFFER_SIZE) -> bool;
 
  private:
-  DiskManager *disk_manager_ __attribute__((__unused__));
-  BufferPoolManager *buffer_pool_manager_ __attribute__((__unused__));
+  /** Hand-off point between the log reader and one redo worker. */
+  struct RedoQueue;
+  /** A page record together with the page it is replayed on; a NEWPAGE record touches two pages. */
+  using RedoTask = std::pair<page_id_t, LogRecord>;
+
+  /** Replay the tasks of a queue until the reader closes it. */
+  void RunRedoWorker(RedoQueue *queue);
+  /** Replay a log record on the given page, which is write-latched and older than the record. */
+  static void RedoRecord(TablePage *page, page_id_t page_id, LogRecord *log_record);
+  /** Revert the effect of a log record of a loser transaction. */
+  void UndoRecord(LogRecord *log_record);
+  /** Read the log record that starts at the given offset of the log file. */
+  auto ReadLogRecord(int offset, LogRecord *log_record) -> bool;
+
+  DiskManager *disk_manager_;
+  BufferPoolManager *buffer_pool_manager_;
+  size_t num_redo_workers_;
 
   /** Maintain active transactions and its corresponding latest lsn. */
   std::unordered_map<txn_id_t, lsn_t> active_txn_;
   /** Mapping the log sequence number to log file offset for undos. */
   std::unordered_map<lsn_t, int> lsn_mapping_;
 
-  int offset_ __attribute__((__unused__));  // NOLINT
+  /** Log file offset of the first byte in log_buffer_. */
+  int offset_;
   char *log_buffer_;
 };
 
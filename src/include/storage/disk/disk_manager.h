@@ -37,7 +37,7 @@ class DiskManager {
   /** FOR TEST / LEADERBOARD ONLY, used by DiskManagerMemory */
   DiskManager() = default;
 
-  virtual ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -45,7 +45,8 @@ class DiskManager {
   void ShutDown();
 
   /**
-   * Write a page to the database file.
+   * Write a page to the database file. Page reads and writes use positional I/O on the database file and may be
+   * issued by several threads at once, as long as no two of them target the same page.
    * @param page_id id of the page
    * @param page_data raw page data
    */
@@ -59,7 +60,7 @@ class DiskManager {
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
   /**
-   * Flush the entire log buffer into disk.
+   * Flush the entire log buffer into disk. Returns once the data is synced to the device.
    * @param log_data raw log data
    * @param size size of log entry
    */
@@ -74,6 +75,32 @@ class DiskManager {
    */
   auto ReadLog(char *log_data, int size, int offset) -> bool;
 
+  /** @return the size of the log file, which is also the offset the next WriteLog() goes to */
+  auto GetLogSize() -> int;
+
+  /**
+   * Release the disk space of the log before the given offset. Records after it keep their offsets, and the released
+   * range reads as zeros.
+   * @param offset offset of the first log record that is still needed
+   */
+  void TruncateLog(int offset);
+
+  /**
+   * Persist the master record, which tells recovery where the log that it needs begins. The record is replaced
+   * atomically.
+   * @param lsn LSN of the log record at offset
+   * @param offset offset in the log file at which recovery starts
+   */
+  void WriteMasterRecord(lsn_t lsn, int offset);
+
+  /**
+   * Read the master record.
+   * @param[out] lsn LSN of the log record at offset
+   * @param[out] offset offset in the log file at which recovery starts
+   * @return false if no master record has been written
+   */
+  auto ReadMasterRecord(lsn_t *lsn, int *offset) -> bool;
+
   /** @return the number of disk flushes */
   auto GetNumFlushes() const -> int;
 
@@ -94,18 +121,20 @@ class DiskManager {
 
  protected:
   auto GetFileSize(const std::string &file_name) -> int;
-  // stream to write log file
-  std::fstream log_io_;
+  // descriptor of the log file, opened for appending
+  int log_fd_{-1};
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // file holding the master record, next to the log file
+  std::string master_name_;
+  // descriptor of the db file, used with pread/pwrite so page I/O needs no shared cursor or latch
+  int db_fd_{-1};
   std::string file_name_;
+  // size of the db file, kept up to date by WritePage so that ReadPage does not stat() the file
+  std::atomic<int64_t> db_file_size_{0};
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
 };
 
 }  // namespace bustub
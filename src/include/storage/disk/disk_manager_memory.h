@@ -9,7 +9,6 @@
 // Copyright (c) 2015-2020, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
-#include <array>
 #include <cstring>
 #include <fstream>
 #include <future>  // NOLINT
@@ -76,12 +75,13 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     }
     if (data_[page_id] == nullptr) {
       data_[page_id] = std::make_shared<ProtectedPage>();
+      data_[page_id]->first.resize(bustub_page_size);
     }
     std::shared_ptr<ProtectedPage> ptr = data_[page_id];
     std::unique_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
+    memcpy(ptr->first.data(), page_data, bustub_page_size);
   }
 
   /**
@@ -103,12 +103,12 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     std::shared_lock<std::shared_mutex> l_page(ptr->second);
     l.unlock();
 
-    memcpy(page_data, ptr->first.data(), BUSTUB_PAGE_SIZE);
+    memcpy(page_data, ptr->first.data(), bustub_page_size);
   }
 
  private:
   std::mutex mutex_;
-  using Page = std::array<char, BUSTUB_PAGE_SIZE>;
+  using Page = std::vector<char>;
   using ProtectedPage = std::pair<Page, std::shared_mutex>;
   std::vector<std::shared_ptr<ProtectedPage>> data_;
 };
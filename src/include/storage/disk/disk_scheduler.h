@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.h
+//
+// Identification: src/include/storage/disk/disk_scheduler.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * @brief Represents a Write or Read request for the DiskManager to execute.
+ */
+struct DiskRequest {
+  /** Flag indicating whether the request is a write or a read. */
+  bool is_write_;
+
+  /**
+   * Pointer to the start of the memory location where a page is either:
+   *   1. being read into from disk (on a read).
+   *   2. being written out to disk (on a write).
+   * The memory has to stay valid until the callback is fulfilled.
+   */
+  char *data_;
+
+  /** ID of the page being read from / written to disk. */
+  page_id_t page_id_;
+
+  /** Callback used to signal to the request issuer when the request has been completed. */
+  std::promise<bool> callback_;
+
+  /** Optional hook run by the worker once the I/O is done, for requests that nobody waits on. */
+  std::function<void()> on_complete_{};
+};
+
+/**
+ * @brief The DiskScheduler hands page reads and writes to a pool of background workers, so that a caller can issue
+ * several requests and wait for all of them instead of doing one blocking I/O after another.
+ *
+ * The workers pick requests in submission order but run them concurrently, so two requests for the same page must
+ * not be in flight at the same time; the buffer pool guarantees that with its I/O-in-progress frame state.
+ */
+class DiskScheduler {
+ public:
+  /**
+   * @brief Creates a new DiskScheduler and starts its workers.
+   * @param disk_manager the disk manager that performs the I/O
+   * @param num_workers the number of background worker threads
+   */
+  explicit DiskScheduler(DiskManager *disk_manager, size_t num_workers = DISK_SCHEDULER_WORKERS);
+
+  DISALLOW_COPY_AND_MOVE(DiskScheduler);
+
+  /**
+   * @brief Waits for the queued requests to finish and stops the workers.
+   */
+  ~DiskScheduler();
+
+  /**
+   * @brief Queues a request for the workers. The request's callback is set to true once the I/O is done.
+   * @param r the request to be scheduled
+   */
+  void Schedule(DiskRequest r);
+
+  /**
+   * @brief Creates a promise object. Use it as the callback of a request and keep its future to wait on.
+   * @return std::promise<bool>
+   */
+  auto CreatePromise() -> std::promise<bool> { return {}; }
+
+ private:
+  /** @brief The loop of every worker: take the next request from the queue and perform it. */
+  void StartWorkerThread();
+
+  /** Pointer to the disk manager. */
+  DiskManager *disk_manager_;
+  /** Requests that no worker has picked up yet. */
+  std::deque<DiskRequest> request_queue_;
+  /** Protects request_queue_ and stopped_. */
+  std::mutex latch_;
+  /** Signaled when a request is queued or the scheduler is stopping. */
+  std::condition_variable cv_;
+  /** Set by the destructor; the workers drain the queue and exit. */
+  bool stopped_{false};
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace bustub
@@ -10,8 +10,10 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -32,6 +34,10 @@ enum Operation { READ, INSERT, DELETE };
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Concurrency uses latch crabbing on the pages alone. Readers hold at most a parent and a child read latch.
+ * Writers first descend with read latches and write-latch only the leaf. They restart with write-latch crabbing
+ * only when the leaf might split or underflow.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -39,8 +45,14 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * @param key_size bytes of each key that pages store, for trees whose keys leave the rest of KeyType zero
+   * @param rid_offset if not negative, leaves do not store values, which must be the RID that RID::Get() encoded at
+   * this offset of the key
+   */
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     int key_size = sizeof(KeyType), int rid_offset = -1);
 
   // Returns true if this B+ tree has no keys and values.
   auto IsEmpty() const -> bool;
@@ -48,12 +60,36 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * Build an empty tree bottom-up from all of its entries at once: sort them, fill the leaves left to right, then each
+   * level of internal pages above. Much cheaper than inserting them one by one, and the nodes come out evenly filled.
+   * Entries with a key that is already loaded are dropped, as Insert() would reject them. Not safe to run while others
+   * use the tree.
+   * @param entries the entries to load, sorted in place
+   * @param fill_factor share of a node's capacity that is filled, leaving room for later inserts; nodes still get at
+   * least their minimum size
+   * @return false if the tree is not empty
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor = BULK_LOAD_FILL_FACTOR)
+      -> bool;
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
   // return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
 
+  /**
+   * Look up many keys in one pass. The keys are visited in sorted order. Each is first searched in the leaf the
+   * previous one ended in and the leaf after it, and only otherwise from the root.
+   * @param keys the keys to look up
+   * @param results set to one collection per key, with the values of the entries from the first key not less than it
+   * on for which match compares equal to it
+   * @param match compares entry keys with the looked up key; nullptr finds just the equal key
+   */
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 const KeyComparator *match = nullptr);
+
   // return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -75,6 +111,15 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
+  /** The node of one tree level that BulkLoad() is filling, and how the level's entries are spread over its nodes. */
+  struct BulkLoadLevel {
+    size_t num_entries_;
+    size_t num_nodes_;
+    size_t nodes_started_{0};
+    size_t entries_left_{0};
+    Page *page_{nullptr};
+  };
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -84,13 +129,20 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  /** How the pages lay out their entries, see BPlusTreePage. */
+  int key_size_;
+  int rid_offset_;
+  /** Serializes creating the root of an empty tree; descents never take it. */
   std::mutex latch_;
+  auto FetchRootPage(Operation op) -> Page *;
+  auto FindLeafPageOptimistic(const KeyType &key, Transaction *transaction, Operation op) -> Page *;
   auto FindLeafPageRW(const KeyType &key, Transaction *transaction, Operation op) -> Page *;
+  auto FindLeafPageFrom(Page *leaf_page, const KeyType &key) -> Page *;
   void InsertInParentRW(Page *page_leaf, const KeyType &key, Page *page_bother, Transaction *transaction);
   void DeleteEntryRW(Page *&page, const KeyType &key, Transaction *transaction);
   void AdjustRootPageRW(Page *page, Transaction *transaction);
@@ -98,6 +150,9 @@ class BPlusTree {
   void RedistributeRW(Page *page, Page *bother_page, Page *parent_page, const KeyType &parent_key, bool ispre,
                       Transaction *transaction);
   auto UnlockAndUnpin(Transaction *transaction, Operation op) -> void;
+  auto BulkLoadNewNode(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &first_key) -> Page *;
+  auto BulkLoadAddChild(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key, page_id_t child_page_id)
+      -> page_id_t;
   auto IsSafe(Page *page, Operation op) -> bool;
 };
 
@@ -14,9 +14,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "common/exception.h"
 #include "container/hash/hash_function.h"
+#include "fmt/format.h"
 #include "storage/index/b_plus_tree.h"
 #include "storage/index/index.h"
 
@@ -35,17 +38,51 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  /** Looks up all keys in one sorted pass over the leaves, see BPlusTree::GetValues. */
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  /** @return an iterator at the first entry whose key is not less than the given key tuple */
+  auto GetBeginIterator(const Tuple &key) -> INDEXITERATOR_TYPE;
+
   auto GetEndIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBPlusTree() -> BPlusTree<KeyType, ValueType, KeyComparator> &;
 
+  /**
+   * Encodes a key tuple. VARCHAR columns that do not fit are cut to a fixed prefix, so such keys only order and match
+   * up to that prefix and callers must recheck the full values.
+   * If the index is not unique, the RID is appended to the key, which makes every entry unique. The default RID sorts
+   * before all others, so a key without it finds the first entry of the key.
+   */
+  auto MakeKey(const Tuple &key, RID rid = RID()) const -> KeyType;
+
+  /**
+   * Encodes the entry stored for a tuple: its key as MakeKey() does, followed by the included columns, which the tree
+   * keeps but does not order by.
+   * @param stored the key columns followed by the included columns, see GetStoredSchema()
+   */
+  auto MakeEntry(const Tuple &stored, RID rid) const -> KeyType;
+
+  /**
+   * Decodes the key and included columns of an entry, in the order of GetStoredAttrs(). The key columns are only the
+   * full values if the key is not lossy, see IsLossyIndexKey().
+   */
+  auto StoredValues(const KeyType &entry) const -> std::vector<Value>;
+
  protected:
+  /** The key columns followed, if the index is not unique, by the RID as a BIGINT. This is what the tree orders by. */
+  Schema entry_schema_;
+  /** The entry schema followed by the included columns: how an entry is laid out in the key bytes. */
+  Schema stored_entry_schema_;
   // comparator for key
   KeyComparator comparator_;
+  /** Compares only the key columns of two entries. */
+  KeyComparator key_comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
@@ -61,4 +98,43 @@ using BPlusTreeIndexIteratorForOneIntegerColumn =
     IndexIterator<IntegerKeyType, IntegerValueType, IntegerComparatorType>;
 using IntegerHashFunctionType = HashFunction<IntegerKeyType>;
 
+/**
+ * Picks the narrowest GenericKey width that holds a key of the given schema, and the RID if the index is not unique.
+ * Keys with VARCHAR columns get the widest width whose nodes still hold a few entries at the current page size, and
+ * keep as much of each string as fits.
+ * @param included_size the bytes of the fixed-size included columns stored after the key
+ * @throw NotImplementedException if the fixed-size columns alone do not fit
+ */
+auto BPlusTreeIndexKeySize(const Schema &key_schema, bool is_unique = true, size_t included_size = 0) -> size_t;
+
+/** @return whether keys of this schema may be cut to a prefix by the index, see BPlusTreeIndex::MakeKey */
+auto IsLossyIndexKey(const Schema &key_schema) -> bool;
+
+/**
+ * Calls func with std::integral_constant<size_t, KeySize> for one of the key widths BPlusTreeIndex is instantiated
+ * with, so that callers can name the matching BPlusTreeIndex, iterator and page types.
+ */
+template <typename Func>
+auto DispatchIndexKeySize(size_t key_size, Func &&func) {
+  switch (key_size) {
+    case 4:
+      return func(std::integral_constant<size_t, 4>{});
+    case 8:
+      return func(std::integral_constant<size_t, 8>{});
+    case 16:
+      return func(std::integral_constant<size_t, 16>{});
+    case 32:
+      return func(std::integral_constant<size_t, 32>{});
+    case 64:
+      return func(std::integral_constant<size_t, 64>{});
+    default:
+      throw Exception(ExceptionType::INVALID, fmt::format("no b+ tree index with key size {}", key_size));
+  }
+}
+
+template <size_t KeySize>
+using BPlusTreeIndexForKeySize = BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+template <size_t KeySize>
+using BPlusTreeIndexIteratorForKeySize = IndexIterator<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+
 }  // namespace bustub
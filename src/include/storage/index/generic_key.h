@@ -13,8 +13,10 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "storage/table/tuple.h"
+#include "type/limits.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -41,7 +43,7 @@ class GenericKey {
     memcpy(data_, &key, sizeof(int64_t));
   }
 
-  inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
+  inline auto ToValue(const Schema *schema, uint32_t column_idx) const -> Value {
     const char *data_ptr;
     const auto &col = schema->GetColumn(column_idx);
     const TypeId column_type = col.GetType();
@@ -78,11 +80,31 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * The constructor looks at the key schema once. Keys made only of integer columns are then compared by loading the
+ * integers straight from the key bytes. Any other schema goes through Value, which handles every type.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    switch (kind_) {
+      case KeyKind::INTEGER:
+        return CompareInteger<int32_t>(lhs.data_, rhs.data_, BUSTUB_INT32_NULL);
+      case KeyKind::BIGINT:
+        return CompareInteger<int64_t>(lhs.data_, rhs.data_, BUSTUB_INT64_NULL);
+      case KeyKind::FIXED_WIDTH:
+        for (const auto &[offset, type] : fixed_columns_) {
+          int cmp = CompareFixedColumn(lhs.data_ + offset, rhs.data_ + offset, type);
+          if (cmp != 0) {
+            return cmp;
+          }
+        }
+        return 0;
+      case KeyKind::GENERIC:
+        break;
+    }
+
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -100,13 +122,66 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    for (const auto &col : key_schema_->GetColumns()) {
+      const TypeId type = col.GetType();
+      if (type != TypeId::TINYINT && type != TypeId::SMALLINT && type != TypeId::INTEGER && type != TypeId::BIGINT) {
+        fixed_columns_.clear();
+        return;
+      }
+      if (col.GetOffset() + col.GetFixedLength() > KeySize) {
+        fixed_columns_.clear();
+        return;
+      }
+      fixed_columns_.emplace_back(col.GetOffset(), type);
+    }
+    if (fixed_columns_.size() == 1 && fixed_columns_[0].first == 0 && fixed_columns_[0].second == TypeId::INTEGER) {
+      kind_ = KeyKind::INTEGER;
+    } else if (fixed_columns_.size() == 1 && fixed_columns_[0].first == 0 &&
+               fixed_columns_[0].second == TypeId::BIGINT) {
+      kind_ = KeyKind::BIGINT;
+    } else if (!fixed_columns_.empty()) {
+      kind_ = KeyKind::FIXED_WIDTH;
+    }
+  }
 
  private:
+  /** How operator() compares keys, picked from the key schema. */
+  enum class KeyKind { GENERIC, INTEGER, BIGINT, FIXED_WIDTH };
+
+  /** A NULL compares neither less nor greater than anything, the same as with Value. */
+  template <typename T>
+  static inline auto CompareInteger(const char *lhs, const char *rhs, T null_value) -> int {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs, sizeof(T));
+    memcpy(&rhs_value, rhs, sizeof(T));
+    if (lhs_value == null_value || rhs_value == null_value) {
+      return 0;
+    }
+    return lhs_value < rhs_value ? -1 : (rhs_value < lhs_value ? 1 : 0);
+  }
+
+  static inline auto CompareFixedColumn(const char *lhs, const char *rhs, TypeId type) -> int {
+    switch (type) {
+      case TypeId::TINYINT:
+        return CompareInteger<int8_t>(lhs, rhs, BUSTUB_INT8_NULL);
+      case TypeId::SMALLINT:
+        return CompareInteger<int16_t>(lhs, rhs, BUSTUB_INT16_NULL);
+      case TypeId::INTEGER:
+        return CompareInteger<int32_t>(lhs, rhs, BUSTUB_INT32_NULL);
+      default:
+        return CompareInteger<int64_t>(lhs, rhs, BUSTUB_INT64_NULL);
+    }
+  }
+
   Schema *key_schema_;
+  KeyKind kind_{KeyKind::GENERIC};
+  /** Offset and type of every key column, when all of them are integers. */
+  std::vector<std::pair<uint32_t, TypeId>> fixed_columns_;
 };
 
 }  // namespace bustub
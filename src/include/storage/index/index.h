@@ -43,11 +43,20 @@ class IndexMetadata {
    * @param table_name The name of the table on which the index is created
    * @param tuple_schema The schema of the indexed key
    * @param key_attrs The mapping from indexed columns to base table columns
+   * @param is_unique Whether the index holds at most one entry per key
+   * @param included_attrs Base table columns that each entry stores next to the key, without ordering by them
    */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> included_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        is_unique_(is_unique),
+        included_attrs_(std::move(included_attrs)) {
     key_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, key_attrs_));
+    stored_attrs_ = key_attrs_;
+    stored_attrs_.insert(stored_attrs_.end(), included_attrs_.begin(), included_attrs_.end());
+    stored_schema_ = std::make_shared<Schema>(Schema::CopySchema(tuple_schema, stored_attrs_));
   }
 
   ~IndexMetadata() = default;
@@ -72,6 +81,18 @@ class IndexMetadata {
   /** @return The mapping relation between indexed columns and base table columns */
   inline auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return key_attrs_; }
 
+  /** @return Whether the index holds at most one entry per key */
+  inline auto IsUnique() const -> bool { return is_unique_; }
+
+  /** @return The base table columns stored in each entry besides the key */
+  inline auto GetIncludedAttrs() const -> const std::vector<uint32_t> & { return included_attrs_; }
+
+  /** @return The key attributes followed by the included attributes */
+  inline auto GetStoredAttrs() const -> const std::vector<uint32_t> & { return stored_attrs_; }
+
+  /** @return The schema of the key columns followed by the included columns */
+  inline auto GetStoredSchema() const -> Schema * { return stored_schema_.get(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -79,6 +100,7 @@ class IndexMetadata {
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
        << "Type = B+Tree, "
+       << "Unique = " << is_unique_ << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
 
@@ -92,8 +114,16 @@ class IndexMetadata {
   std::string table_name_;
   /** The mapping relation between key schema and tuple schema */
   const std::vector<uint32_t> key_attrs_;
+  /** Whether the index holds at most one entry per key */
+  const bool is_unique_;
+  /** The base table columns stored next to the key */
+  const std::vector<uint32_t> included_attrs_;
+  /** The key attributes followed by the included attributes */
+  std::vector<uint32_t> stored_attrs_;
   /** The schema of the indexed key */
   std::shared_ptr<Schema> key_schema_;
+  /** The schema of the key columns followed by the included columns */
+  std::shared_ptr<Schema> stored_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -139,6 +169,15 @@ class Index {
   /** @return The index key attributes */
   auto GetKeyAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetKeyAttrs(); }
 
+  /** @return Whether the index holds at most one entry per key */
+  auto IsUnique() const -> bool { return metadata_->IsUnique(); }
+
+  /** @return The key attributes followed by the attributes of the columns included in the entries */
+  auto GetStoredAttrs() const -> const std::vector<uint32_t> & { return metadata_->GetStoredAttrs(); }
+
+  /** @return The schema of the tuples passed to InsertEntry() and DeleteEntry() */
+  auto GetStoredSchema() const -> Schema * { return metadata_->GetStoredSchema(); }
+
   /** @return A string representation for debugging */
   auto ToString() const -> std::string {
     std::stringstream os;
@@ -153,7 +192,7 @@ class Index {
 
   /**
    * Insert an entry into the index.
-   * @param key The index key
+   * @param key The index key followed by the included columns, see GetStoredSchema()
    * @param rid The RID associated with the key
    * @param transaction The transaction context
    */
@@ -161,8 +200,8 @@ class Index {
 
   /**
    * Delete an index entry by key.
-   * @param key The index key
-   * @param rid The RID associated with the key (unused)
+   * @param key The index key, which may be followed by the included columns
+   * @param rid The RID associated with the key; only the entry with this RID is deleted if the index is not unique
    * @param transaction The transaction context
    */
   virtual void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
@@ -170,11 +209,26 @@ class Index {
   /**
    * Search the index for the provided key.
    * @param key The index key
-   * @param result The collection of RIDs that is populated with results of the search
+   * @param result The collection of RIDs that is populated with results of the search, all entries of the key if the
+   * index is not unique
    * @param transaction The transaction context
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Search the index for many keys at once. Indexes that can share work between the keys override this.
+   * @param keys The index keys
+   * @param results Set to one collection per key, holding what ScanKey() finds for it
+   * @param transaction The transaction context
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->assign(keys.size(), {});
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -25,6 +25,11 @@ class IndexIterator {
   // you may define your own constructor based on your member variables
   IndexIterator();
   IndexIterator(Page *curr_page, int index, page_id_t page_id, BufferPoolManager *bufferPoolManager);
+  IndexIterator(const IndexIterator &) = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
+  /** Releases the leaf the iterator still holds, so a scan may stop before reaching the end. */
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -46,6 +51,12 @@ class IndexIterator {
   Page *curr_page_ = nullptr;
   int index_ = 0;
   BufferPoolManager *buffer_pool_manager_ = nullptr;
+  /** Whether curr_page_ is pinned and read-latched by this iterator. */
+  bool latched_ = false;
+  /** The entry operator* read last; pages store entries packed, so they are copied out. */
+  MappingType entry_;
+
+  void Release();
 };
 
 }  // namespace bustub
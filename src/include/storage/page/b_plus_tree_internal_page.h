@@ -18,7 +18,10 @@ namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_SIZE INTERNAL_PAGE_SLOTS(sizeof(KeyType))
+/** Number of children that fit an internal page whose keys take key_size bytes */
+#define INTERNAL_PAGE_SLOTS(key_size) \
+  static_cast<int>((bustub_page_size - INTERNAL_PAGE_HEADER_SIZE) / ((key_size) + sizeof(page_id_t)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -31,13 +34,15 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Each KEY is cut to the header's KeySize, see BPlusTreePage.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   // must call initialize method after "create" a new node
-  std::mutex bother_latch_;
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE,
+            int key_size = sizeof(KeyType));
 
   auto KeyAt(int index) const -> KeyType;
   void SetKeyAt(int index, const KeyType &key);
@@ -57,7 +62,14 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void Merge(const KeyType &key, Page *right_page, BufferPoolManager *buffer_pool_manager_);
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
+  /** @return the bytes one entry takes */
+  auto SlotSize() const -> size_t;
+  auto SlotAt(int index) -> char *;
+  auto SlotAt(int index) const -> const char *;
+  /** Moves count entries from index from to index to; the ranges may overlap. */
+  void MoveSlots(int from, int to, int count);
+
+  // Flexible array member for the packed entries.
+  char slots_[1];
 };
 }  // namespace bustub
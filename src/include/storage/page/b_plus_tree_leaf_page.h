@@ -19,7 +19,10 @@ namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_SIZE LEAF_PAGE_SLOTS(sizeof(KeyType), sizeof(ValueType))
+/** Number of entries that fit a leaf page whose entries take key_size bytes of key and value_size bytes of value */
+#define LEAF_PAGE_SLOTS(key_size, value_size) \
+  static_cast<int>((bustub_page_size - LEAF_PAGE_HEADER_SIZE) / ((key_size) + (value_size)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -31,20 +34,23 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
+ * Each KEY is cut to the header's KeySize, and the RIDs are left out if they are part of the keys, see BPlusTreePage.
+ *
  *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (1) | KeySize (1) | RidOffset (1) | (1) | LSN (4) | CurrentSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  -----------------------------------------------------------
+ * | MaxSize (4) | ParentPageId (4) | PageId (4) | NextPageId (4)
+ *  -----------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE,
+            int key_size = sizeof(KeyType), int rid_offset = -1);
   // helper methods
   auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
@@ -58,12 +64,20 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto ValueAt(int index) const -> ValueType;
   void InsertFirst(const KeyType &key, const ValueType &value);
   void InsertLast(const KeyType &key, const ValueType &value);
-  auto GetPair(int index) -> MappingType &;
-  void Merge(Page *right_page, BufferPoolManager *buffer_pool_manager_);
+  auto GetPair(int index) const -> MappingType;
+  void Merge(Page *right_page);
 
  private:
+  /** @return the bytes one entry takes */
+  auto SlotSize() const -> size_t;
+  auto SlotAt(int index) -> char *;
+  auto SlotAt(int index) const -> const char *;
+  void SetAt(int index, const KeyType &key, const ValueType &value);
+  /** Moves count entries from index from to index to; the ranges may overlap. */
+  void MoveSlots(int from, int to, int count);
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  // Flexible array member for the packed entries.
+  char slots_[1];
 };
 }  // namespace bustub
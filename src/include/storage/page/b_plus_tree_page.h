@@ -25,7 +25,7 @@ namespace bustub {
 #define INDEX_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType, typename KeyComparator>
 
 // define page type enum
-enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
+enum class IndexPageType : uint8_t { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
 
 /**
  * Both internal and leaf page are inherited from this page.
@@ -35,10 +35,14 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  *
  * Header format (size in byte, 24 bytes in total):
  * ----------------------------------------------------------------------------
- * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (1) | KeySize (1) | RidOffset (1) | (1) | LSN (4) | CurrentSize (4) |
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | MaxSize (4) | ParentPageId (4) | PageId(4) |
  * ----------------------------------------------------------------------------
+ *
+ * Entries are packed back to back and store only the first KeySize bytes of their key; the rest of every key the
+ * tree is given must be zero. A RidOffset that is not negative tells leaf pages not to store values: the value of an
+ * entry is then the RID that RID::Get() encoded at that offset of its key.
  */
 class BPlusTreePage {
  public:
@@ -63,9 +67,15 @@ class BPlusTreePage {
   void SetLSN(lsn_t lsn = INVALID_LSN);
   auto GetLSN() const -> lsn_t;
 
+  auto GetKeySize() const -> int;
+  auto GetRidOffset() const -> int;
+  void SetKeyLayout(int key_size, int rid_offset = -1);
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_ __attribute__((__unused__));
+  uint8_t key_size_ __attribute__((__unused__));
+  int8_t rid_offset_ __attribute__((__unused__));
   lsn_t lsn_ __attribute__((__unused__));
   int size_ __attribute__((__unused__));
   int max_size_ __attribute__((__unused__));
@@ -22,11 +22,12 @@
 /**
  * BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a linear probe hash block page. It is an
  * approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each
- * key/value pair, we need two additional bits for occupied_ and readable_. 4 * BUSTUB_PAGE_SIZE / (4 * sizeof
- * (MappingType) + 1) = BUSTUB_PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
- * to maintain the occupied and readable flags for a key value pair.
+ * key/value pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof
+ * (MappingType) + 1) = PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
+ * to maintain the occupied and readable flags for a key value pair. The arrays are compiled in, so PAGE_SIZE is the
+ * smallest page size, DEFAULT_BUSTUB_PAGE_SIZE, and a block fits whatever page size is configured at startup.
  */
-#define BLOCK_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BLOCK_ARRAY_SIZE (4 * DEFAULT_BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
 /**
  * Extendible Hashing Definitions
@@ -38,7 +39,7 @@
  * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
  * of search, insertion, removal, and helper methods.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * DEFAULT_BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
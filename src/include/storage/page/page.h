@@ -30,11 +30,11 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. Allocates bustub_page_size bytes of page data and zeros them out. */
+  Page() : data_(new char[bustub_page_size]) { ResetMemory(); }
 
-  /** Default destructor. */
-  ~Page() = default;
+  /** Destructor. Frees the page data. */
+  ~Page() { delete[] data_; }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -76,10 +76,10 @@ class Page {
 
  private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, bustub_page_size); }
 
-  /** The actual data that is stored within a page. */
-  char data_[BUSTUB_PAGE_SIZE]{};
+  /** The actual data that is stored within a page, bustub_page_size bytes long. */
+  char *data_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
@@ -6,10 +6,6 @@
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,20 +13,64 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * FreeSpace is the offset where the last inserted tuple starts. A page holds tuples only until they are read back,
+ * e.g. the partitions that a hash join spills, so there is no way to delete a tuple.
  */
 class TmpTuplePage : public Page {
  public:
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    SetLSN(INVALID_LSN);
+    SetFreeSpacePointer(page_size);
+  }
+
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Append a tuple to the page.
+   * @param tuple The tuple
+   * @param[out] out Where the tuple was stored
+   * @return `false` if the page has no room for the tuple
+   */
+  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool {
+    const uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    const uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_PAGE_HEADER + size) {
+      return false;
+    }
+    const uint32_t offset = free_space_pointer - size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
   }
 
-  auto GetTablePageId() -> page_id_t { return INVALID_PAGE_ID; }
+  /**
+   * Read a tuple of the page.
+   * @param offset Where the tuple is stored, see TmpTuple::GetOffset()
+   * @param[out] tuple The tuple
+   * @return The offset of the tuple inserted before it, which is the page size after the first tuple
+   */
+  auto Get(size_t offset, Tuple *tuple) -> size_t {
+    tuple->DeserializeFrom(GetData() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
 
-  auto Insert(const Tuple &tuple, TmpTuple *out) -> bool { return false; }
+  /** @return The offset of the last inserted tuple; reading from here to the page end visits all tuples */
+  auto GetFreeSpacePointer() -> uint32_t {
+    return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE);
+  }
 
  private:
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
 };
 
 }  // namespace bustub
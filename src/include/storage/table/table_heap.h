@@ -95,9 +95,12 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param acquire_read_lock whether to latch the page, false if the caller already holds the latch
+   * @param access_type how the page is accessed, passed on to the buffer pool
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true,
+                AccessType access_type = AccessType::Unknown) -> bool;
 
   /** @return the begin iterator of this table */
   auto Begin(Transaction *txn) -> TableIterator;
@@ -21,9 +21,13 @@
 namespace bustub {
 
 class TableHeap;
+class TablePage;
 
 /**
  * TableIterator enables the sequential scan of a TableHeap.
+ *
+ * Pages are fetched with AccessType::Scan, and the iterator asks the buffer pool to read up to TABLE_SCAN_READ_AHEAD
+ * pages of the page chain ahead of its position.
  */
 class TableIterator {
   friend class Cursor;
@@ -32,7 +36,11 @@ class TableIterator {
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        read_ahead_page_id_(other.read_ahead_page_id_),
+        read_ahead_distance_(other.read_ahead_distance_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -54,13 +62,26 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    read_ahead_page_id_ = other.read_ahead_page_id_;
+    read_ahead_distance_ = other.read_ahead_distance_;
     return *this;
   }
 
  private:
+  /**
+   * Called whenever the scan moves to a new page. Extends the read-ahead window from the last page read ahead, whose
+   * successor is only known once the page itself is in memory.
+   * @param cur_page the page the scan has moved to, read latched
+   */
+  void ReadAhead(TablePage *cur_page);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The furthest page of the chain that has been read ahead, or the current page if none has. */
+  page_id_t read_ahead_page_id_{INVALID_PAGE_ID};
+  /** How many pages read_ahead_page_id_ is ahead of the current page. */
+  int read_ahead_distance_{0};
 };
 
 }  // namespace bustub
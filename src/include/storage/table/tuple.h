@@ -40,14 +40,20 @@ class Tuple {
   explicit Tuple(RID rid) : rid_(rid) {}
 
   // constructor for creating a new tuple based on input value
-  Tuple(std::vector<Value> values, const Schema *schema);
+  Tuple(const std::vector<Value> &values, const Schema *schema);
 
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
+  // move constructor, takes over the data of other
+  Tuple(Tuple &&other) noexcept;
+
   // assign operator, deep copy
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move assign operator, takes over the data of other
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -4,8 +4,10 @@
 #include "fmt/ranges.h"
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 
 #include "myapi/api_manager.h"
+#include "storage/index/b_plus_tree_index.h"
 
 ApiManager::ApiManager(bustub::BustubInstance *bustub_instance) 
     : kBustubInstance_(bustub_instance)
@@ -209,50 +211,64 @@ bool ApiManager::GetBufferPoolInfo(ApiContext &ctx) {
         return false;
     }
     
-    bustub::BufferPoolManagerInstance *buffer_pool = 
-        dynamic_cast<bustub::BufferPoolManagerInstance*>(kBustubInstance_->buffer_pool_manager_);
+    // A parallel buffer pool is shown as its shards laid out one after another.
+    std::vector<bustub::BufferPoolManagerInstance*> buffer_pools;
+    auto *parallel_buffer_pool = 
+        dynamic_cast<bustub::ParallelBufferPoolManager*>(kBustubInstance_->buffer_pool_manager_);
+    if (parallel_buffer_pool != nullptr) {
+        for (size_t i = 0; i < parallel_buffer_pool->GetNumInstances(); ++i) {
+            buffer_pools.push_back(parallel_buffer_pool->GetInstance(i));
+        }
+    } else {
+        buffer_pools.push_back(
+            dynamic_cast<bustub::BufferPoolManagerInstance*>(kBustubInstance_->buffer_pool_manager_));
+    }
 
-    if (buffer_pool == nullptr) {
+    if (buffer_pools.back() == nullptr) {
         ctx.err_msg = "Fail to access buffer pool of BusTub.";
         return false;
     }
 
-    std::unordered_set<bustub::frame_id_t> free_frame_ids;
-    for (auto &frame_id : buffer_pool->GetFreeList()) {
-        free_frame_ids.emplace(frame_id);
-    }
-
     rapidjson::Value resp_info(rapidjson::kArrayType);
-    bustub::Page *pages = buffer_pool->GetPages();
-    for (size_t i = 0; i < buffer_pool->GetPoolSize(); ++i) {
-        bustub::Page &page = pages[i];
-        rapidjson::Value resp_page_info(rapidjson::kObjectType);
-        resp_page_info.AddMember(
-            "frame_id", 
-            rapidjson::Value(i), 
-            ctx.resp_allocator
-        );
-        resp_page_info.AddMember(
-            "page_id", 
-            rapidjson::Value(page.GetPageId()), 
-            ctx.resp_allocator
-        );
-        resp_page_info.AddMember(
-            "is_dirty",
-            rapidjson::Value(page.IsDirty()),
-            ctx.resp_allocator
-        );
-        resp_page_info.AddMember(
-            "pin_count",
-            rapidjson::Value(page.GetPinCount()),
-            ctx.resp_allocator
-        );
-        resp_page_info.AddMember(
-            "is_free",
-            rapidjson::Value(free_frame_ids.find(i) != free_frame_ids.end()),
-            ctx.resp_allocator
-        );
-        resp_info.PushBack(resp_page_info, ctx.resp_allocator);
+    size_t frame_id_base = 0;
+    for (auto *buffer_pool : buffer_pools) {
+        std::unordered_set<bustub::frame_id_t> free_frame_ids;
+        for (auto &frame_id : buffer_pool->GetFreeList()) {
+            free_frame_ids.emplace(frame_id);
+        }
+
+        bustub::Page *pages = buffer_pool->GetPages();
+        for (size_t i = 0; i < buffer_pool->GetPoolSize(); ++i) {
+            bustub::Page &page = pages[i];
+            rapidjson::Value resp_page_info(rapidjson::kObjectType);
+            resp_page_info.AddMember(
+                "frame_id", 
+                rapidjson::Value(frame_id_base + i), 
+                ctx.resp_allocator
+            );
+            resp_page_info.AddMember(
+                "page_id", 
+                rapidjson::Value(page.GetPageId()), 
+                ctx.resp_allocator
+            );
+            resp_page_info.AddMember(
+                "is_dirty",
+                rapidjson::Value(page.IsDirty()),
+                ctx.resp_allocator
+            );
+            resp_page_info.AddMember(
+                "pin_count",
+                rapidjson::Value(page.GetPinCount()),
+                ctx.resp_allocator
+            );
+            resp_page_info.AddMember(
+                "is_free",
+                rapidjson::Value(free_frame_ids.find(i) != free_frame_ids.end()),
+                ctx.resp_allocator
+            );
+            resp_info.PushBack(resp_page_info, ctx.resp_allocator);
+        }
+        frame_id_base += buffer_pool->GetPoolSize();
     }
 
     ctx.resp_data.AddMember("buffer_pool_info", resp_info, ctx.resp_allocator);
@@ -338,7 +354,7 @@ bool ApiManager::GetTablePageInfo(ApiContext &ctx) {
     );
     ctx.resp_data.AddMember(
         "size_of_tuple_array",
-        rapidjson::Value(bustub::BUSTUB_PAGE_SIZE - bustub::TablePage::SIZE_TABLE_PAGE_HEADER - table_page->GetFreeSpaceRemaining()),
+        rapidjson::Value(bustub::bustub_page_size - bustub::TablePage::SIZE_TABLE_PAGE_HEADER - table_page->GetFreeSpaceRemaining()),
         ctx.resp_allocator
     );
 
@@ -439,10 +455,6 @@ bool ApiManager::GetTupleInfo(ApiContext &ctx) {
 
 bool ApiManager::QueryBPlusTree(ApiContext &ctx){
 
-    using LeafPage = bustub::BPlusTreeLeafPage<bustub::IntegerKeyType,bustub::IntegerValueType,bustub::IntegerComparatorType>;
-    using InternalPage = bustub::BPlusTreeInternalPage<bustub::IntegerKeyType,bustub::page_id_t,bustub::IntegerComparatorType>;
-    using BPlusTreeIndex = bustub::BPlusTreeIndex<bustub::IntegerKeyType, bustub::IntegerValueType, bustub::IntegerComparatorType>;
-
      if (!ctx.req_data.HasMember("index_oid") || !ctx.req_data["index_oid"].IsNumber()) {
         ctx.err_msg = "Missing or invalid 'index_oid' field";
         return false;
@@ -455,104 +467,129 @@ bool ApiManager::QueryBPlusTree(ApiContext &ctx){
         ctx.err_msg = "Can't find this index";
         return false;
     }
-    
-    auto index = dynamic_cast<BPlusTreeIndex*>(index_info->index_.get());
-    if (index == nullptr) {
-        ctx.err_msg = "Fail to fetch this b plus tree index.";
-        return false;
-    }
-    if (index -> GetBPlusTree().IsEmpty() == true) {
-        ctx.err_msg = "BPlusTree of the index is empty";
-        return false;
-    }
 
-    rapidjson::Value resp_root(rapidjson::kObjectType);
-    rapidjson::Value resp_nodes(rapidjson::kArrayType);
+    // The page layout depends on the key width the index was created with.
+    return bustub::DispatchIndexKeySize(index_info->key_size_, [&](auto key_size) -> bool {
+        constexpr size_t KEY_SIZE = decltype(key_size)::value;
+        using KeyType = bustub::GenericKey<KEY_SIZE>;
+        using LeafPage = bustub::BPlusTreeLeafPage<KeyType, bustub::RID, bustub::GenericComparator<KEY_SIZE>>;
+        using InternalPage = bustub::BPlusTreeInternalPage<KeyType, bustub::page_id_t, bustub::GenericComparator<KEY_SIZE>>;
+        using BPlusTreeIndex = bustub::BPlusTreeIndexForKeySize<KEY_SIZE>;
+
+        // A single integer column is reported as a number, any other key as its values, e.g. "(1, abc)".
+        bustub::Schema *key_schema = index_info->index_->GetKeySchema();
+        const bool integer_key = key_schema->GetColumnCount() == 1 && key_schema->GetColumn(0).GetType() == bustub::TypeId::INTEGER;
+        auto key_to_json = [&](const KeyType &key) -> rapidjson::Value {
+            if (integer_key) {
+                return rapidjson::Value(key.ToInt32());
+            }
+            std::vector<std::string> values;
+            for (uint32_t i = 0; i < key_schema->GetColumnCount(); i ++) {
+                values.push_back(key.ToValue(key_schema, i).ToString());
+            }
+            std::string text = values.size() == 1 ? values[0] : fmt::format("({})", fmt::join(values, ", "));
+            return rapidjson::Value(text.c_str(), ctx.resp_allocator);
+        };
+
+        auto index = dynamic_cast<BPlusTreeIndex*>(index_info->index_.get());
+        if (index == nullptr) {
+            ctx.err_msg = "Fail to fetch this b plus tree index.";
+            return false;
+        }
+        if (index -> GetBPlusTree().IsEmpty() == true) {
+            ctx.err_msg = "BPlusTree of the index is empty";
+            return false;
+        }
+
+        rapidjson::Value resp_root(rapidjson::kObjectType);
+        rapidjson::Value resp_nodes(rapidjson::kArrayType);
     
-    std::queue<bustub::page_id_t> page_id_queue;
-    bustub::page_id_t root_page_id = index -> GetBPlusTree().GetRootPageId();
-    page_id_queue.push(root_page_id); 
+        std::queue<bustub::page_id_t> page_id_queue;
+        bustub::page_id_t root_page_id = index -> GetBPlusTree().GetRootPageId();
+        page_id_queue.push(root_page_id); 
     
-    while(!page_id_queue.empty()){
-        rapidjson::Value resp_header(rapidjson::kObjectType);
-        rapidjson::Value resp_key_value_list(rapidjson::kArrayType);
-        auto cur_page_id = page_id_queue.front();
-        auto cur_page = reinterpret_cast<bustub::BPlusTreePage*>(
-            kBustubInstance_->buffer_pool_manager_->FetchPage(cur_page_id)->GetData()
-        );
-        page_id_queue.pop();
-        resp_header.AddMember("current_size", cur_page->GetSize(), ctx.resp_allocator);
-        resp_header.AddMember("max_size", cur_page->GetMaxSize(), ctx.resp_allocator);
-        resp_header.AddMember("page_id", cur_page->GetPageId(), ctx.resp_allocator);
+        while(!page_id_queue.empty()){
+            rapidjson::Value resp_header(rapidjson::kObjectType);
+            rapidjson::Value resp_key_value_list(rapidjson::kArrayType);
+            auto cur_page_id = page_id_queue.front();
+            auto cur_page = reinterpret_cast<bustub::BPlusTreePage*>(
+                kBustubInstance_->buffer_pool_manager_->FetchPage(cur_page_id)->GetData()
+            );
+            page_id_queue.pop();
+            resp_header.AddMember("current_size", cur_page->GetSize(), ctx.resp_allocator);
+            resp_header.AddMember("max_size", cur_page->GetMaxSize(), ctx.resp_allocator);
+            resp_header.AddMember("page_id", cur_page->GetPageId(), ctx.resp_allocator);
         
-        if (cur_page -> IsLeafPage()) {
-            // At first, check the information of header.
-            resp_header.AddMember("parent_page_id", cur_page->GetParentPageId(), ctx.resp_allocator);
-            resp_header.AddMember("page_type",rapidjson::Value().SetString("leaf_page", ctx.resp_allocator), ctx.resp_allocator);
+            if (cur_page -> IsLeafPage()) {
+                // At first, check the information of header.
+                resp_header.AddMember("parent_page_id", cur_page->GetParentPageId(), ctx.resp_allocator);
+                resp_header.AddMember("page_type",rapidjson::Value().SetString("leaf_page", ctx.resp_allocator), ctx.resp_allocator);
             
-            // Then, let's check the children of this node, in order to compute the `key_value` field.
-            auto curr_page = reinterpret_cast<LeafPage*>(cur_page);
-            resp_header.AddMember("next_page_id", curr_page->GetNextPageId(), ctx.resp_allocator);
-            for (int i = 0; i < curr_page->GetSize(); i ++) {
-                rapidjson::Value resp_kv(rapidjson::kObjectType);
-                rapidjson::Value resp_rid(rapidjson::kObjectType);
-                resp_kv.AddMember( "index",     curr_page->KeyAt(i).ToInt32(),     ctx.resp_allocator);
-                // Check the information of rid.
-                resp_rid.AddMember("page_id",   curr_page->ValueAt(i).GetPageId(),  ctx.resp_allocator);
-                resp_rid.AddMember("slot_num",  curr_page->ValueAt(i).GetSlotNum(), ctx.resp_allocator);
-                resp_kv.AddMember( "rid",       resp_rid,                           ctx.resp_allocator);
-                // Update the key_value list.
-                resp_key_value_list.PushBack(resp_kv, ctx.resp_allocator);
-            }
-
-            // Finally, let's record the `header` and `key_value` field.
-            // And add the information of this node to `resp_root` or `resp_node`.
-            if (cur_page->IsRootPage()) {
-                resp_root.AddMember("header", resp_header, ctx.resp_allocator);
-                resp_root.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
-            } else {
-                rapidjson::Value resp_node(rapidjson::kObjectType); 
-                resp_node.AddMember("header", resp_header, ctx.resp_allocator);
-                resp_node.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
-                resp_nodes.PushBack(resp_node, ctx.resp_allocator);
-            }
+                // Then, let's check the children of this node, in order to compute the `key_value` field.
+                auto curr_page = reinterpret_cast<LeafPage*>(cur_page);
+                resp_header.AddMember("next_page_id", curr_page->GetNextPageId(), ctx.resp_allocator);
+                for (int i = 0; i < curr_page->GetSize(); i ++) {
+                    rapidjson::Value resp_kv(rapidjson::kObjectType);
+                    rapidjson::Value resp_rid(rapidjson::kObjectType);
+                    resp_kv.AddMember( "index",     key_to_json(curr_page->KeyAt(i)),  ctx.resp_allocator);
+                    // Check the information of rid.
+                    resp_rid.AddMember("page_id",   curr_page->ValueAt(i).GetPageId(),  ctx.resp_allocator);
+                    resp_rid.AddMember("slot_num",  curr_page->ValueAt(i).GetSlotNum(), ctx.resp_allocator);
+                    resp_kv.AddMember( "rid",       resp_rid,                           ctx.resp_allocator);
+                    // Update the key_value list.
+                    resp_key_value_list.PushBack(resp_kv, ctx.resp_allocator);
+                }
+
+                // Finally, let's record the `header` and `key_value` field.
+                // And add the information of this node to `resp_root` or `resp_node`.
+                if (cur_page->IsRootPage()) {
+                    resp_root.AddMember("header", resp_header, ctx.resp_allocator);
+                    resp_root.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
+                } else {
+                    rapidjson::Value resp_node(rapidjson::kObjectType); 
+                    resp_node.AddMember("header", resp_header, ctx.resp_allocator);
+                    resp_node.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
+                    resp_nodes.PushBack(resp_node, ctx.resp_allocator);
+                }
             
-        }
-        else {
-            // At first, check the information of header.
-            resp_header.AddMember("parent_page_id", cur_page->GetParentPageId(), ctx.resp_allocator);
-            resp_header.AddMember("page_type",rapidjson::Value().SetString("internal_page", ctx.resp_allocator), ctx.resp_allocator);
-            
-            // Then, let's check the children of this node, in order to compute the `key_value` field.
-            auto curr_page = reinterpret_cast<InternalPage*>(cur_page);
-            for(int i = 0; i < curr_page->GetSize(); i ++){
-                rapidjson::Value resp_kv(rapidjson::kObjectType);
-                resp_kv.AddMember("index", curr_page->KeyAt(i).ToInt32(), ctx.resp_allocator);
-                resp_kv.AddMember("page_id", curr_page->ValueAt(i), ctx.resp_allocator);
-                // Update the key_value list.
-                resp_key_value_list.PushBack(resp_kv, ctx.resp_allocator);
-                // As an internal node, don't forget to update `page_id_queue`.
-                page_id_queue.push(curr_page->ValueAt(i));
             }
-
-            // Finally, let's record the `header` and `key_value` field.
-            // And add the information of this node to `resp_root` or `resp_node`.
-            if (cur_page->IsRootPage()) {
-                resp_root.AddMember("header", resp_header, ctx.resp_allocator);
-                resp_root.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
-            } else {
-                rapidjson::Value resp_node(rapidjson::kObjectType); 
-                resp_node.AddMember("header", resp_header, ctx.resp_allocator);
-                resp_node.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
-                resp_nodes.PushBack(resp_node, ctx.resp_allocator);
+            else {
+                // At first, check the information of header.
+                resp_header.AddMember("parent_page_id", cur_page->GetParentPageId(), ctx.resp_allocator);
+                resp_header.AddMember("page_type",rapidjson::Value().SetString("internal_page", ctx.resp_allocator), ctx.resp_allocator);
+            
+                // Then, let's check the children of this node, in order to compute the `key_value` field.
+                auto curr_page = reinterpret_cast<InternalPage*>(cur_page);
+                for(int i = 0; i < curr_page->GetSize(); i ++){
+                    rapidjson::Value resp_kv(rapidjson::kObjectType);
+                    // The first key of an internal node is unused and may hold stale bytes.
+                    resp_kv.AddMember("index", i == 0 && !integer_key ? rapidjson::Value("", ctx.resp_allocator) : key_to_json(curr_page->KeyAt(i)), ctx.resp_allocator);
+                    resp_kv.AddMember("page_id", curr_page->ValueAt(i), ctx.resp_allocator);
+                    // Update the key_value list.
+                    resp_key_value_list.PushBack(resp_kv, ctx.resp_allocator);
+                    // As an internal node, don't forget to update `page_id_queue`.
+                    page_id_queue.push(curr_page->ValueAt(i));
+                }
+
+                // Finally, let's record the `header` and `key_value` field.
+                // And add the information of this node to `resp_root` or `resp_node`.
+                if (cur_page->IsRootPage()) {
+                    resp_root.AddMember("header", resp_header, ctx.resp_allocator);
+                    resp_root.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
+                } else {
+                    rapidjson::Value resp_node(rapidjson::kObjectType); 
+                    resp_node.AddMember("header", resp_header, ctx.resp_allocator);
+                    resp_node.AddMember("key_value", resp_key_value_list, ctx.resp_allocator);
+                    resp_nodes.PushBack(resp_node, ctx.resp_allocator);
+                }
             }
         }
-    }
 
-    ctx.resp_data.AddMember("root", resp_root, ctx.resp_allocator);
-    ctx.resp_data.AddMember("nodes", resp_nodes, ctx.resp_allocator);
+        ctx.resp_data.AddMember("root", resp_root, ctx.resp_allocator);
+        ctx.resp_data.AddMember("nodes", resp_nodes, ctx.resp_allocator);
 
-    return true;
+        return true;
+    });
 }
 
 auto ApiManager::DispatchRequest(const std::string &request) -> std::string {
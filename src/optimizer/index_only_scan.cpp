@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "optimizer/optimizer.h"
+#include "storage/index/b_plus_tree_index.h"
+
+namespace bustub {
+
+namespace {
+
+/** Adds the columns of its input that an expression reads. */
+void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *columns) {
+  if (const auto *column_value_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+      column_value_expr != nullptr) {
+    columns->push_back(column_value_expr->GetColIdx());
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeIndexOnlyScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeIndexOnlyScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Projections and aggregations are where it is known which columns of a scan are still needed.
+  std::vector<AbstractExpressionRef> exprs;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    exprs = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions();
+  } else if (optimized_plan->GetType() == PlanType::Aggregation) {
+    const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    exprs = agg_plan.GetGroupBys();
+    exprs.insert(exprs.end(), agg_plan.GetAggregates().begin(), agg_plan.GetAggregates().end());
+  } else {
+    return optimized_plan;
+  }
+
+  // The scan may sit below a filter with the comparisons its key range does not cover.
+  BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "must have exactly one child");
+  AbstractPlanNodeRef child_plan = optimized_plan->children_[0];
+  AbstractPlanNodeRef scan_plan = child_plan;
+  if (child_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*child_plan);
+    exprs.push_back(filter_plan.GetPredicate());
+    scan_plan = filter_plan.GetChildPlan();
+  }
+  if (scan_plan->GetType() != PlanType::IndexScan) {
+    return optimized_plan;
+  }
+  const auto &index_scan = dynamic_cast<const IndexScanPlanNode &>(*scan_plan);
+  const auto *index_info = catalog_.GetIndex(index_scan.GetIndexOid());
+  // Strings cut to a prefix in the key can't be given back.
+  if (index_scan.index_only_ || IsLossyIndexKey(index_info->key_schema_)) {
+    return optimized_plan;
+  }
+
+  std::vector<uint32_t> columns;
+  for (const auto &expr : exprs) {
+    CollectColumns(expr, &columns);
+  }
+  const auto &stored_attrs = index_info->index_->GetStoredAttrs();
+  for (uint32_t column : columns) {
+    if (std::find(stored_attrs.begin(), stored_attrs.end(), column) == stored_attrs.end()) {
+      return optimized_plan;
+    }
+  }
+
+  auto index_only_scan = std::make_shared<IndexScanPlanNode>(index_scan);
+  index_only_scan->index_only_ = true;
+  if (child_plan != scan_plan) {
+    child_plan = child_plan->CloneWithChildren({index_only_scan});
+  } else {
+    child_plan = index_only_scan;
+  }
+  return optimized_plan->CloneWithChildren({child_plan});
+}
+
+}  // namespace bustub
@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <memory>
+#include <optional>
+#include <vector>
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
@@ -10,8 +12,10 @@
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
+#include "execution/plans/mock_scan_plan.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
 #include "optimizer/optimizer.h"
 #include "type/type_id.h"
 
@@ -24,42 +28,59 @@ auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> Abstra
   }
   auto optimized_plan = plan->CloneWithChildren(std::move(children));
 
-  if (optimized_plan->GetType() == PlanType::NestedLoopJoin) {
-    const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
-    // Has exactly two children
-    BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
+  if (optimized_plan->GetType() != PlanType::NestedLoopJoin) {
+    return optimized_plan;
+  }
+  const auto &nlj_plan = dynamic_cast<const NestedLoopJoinPlanNode &>(*optimized_plan);
+  // Has exactly two children
+  BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
 
-    // Check if expr is equal condition where one is for the left table, and one is for the right table.
-    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate()); expr != nullptr) {
-      if (expr->comp_type_ == ComparisonType::Equal) {
-        if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-            left_expr != nullptr) {
-          if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-              right_expr != nullptr) {
-            // Ensure both exprs have tuple_id == 0
-            auto left_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType());
-            auto right_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType());
-            // Now it's in form of <column_expr> = <column_expr>. Let's check if one of them is from the left table, and
-            // the other is from the right table.
-            if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
-              return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                        nlj_plan.GetRightPlan(), std::move(left_expr_tuple_0),
-                                                        std::move(right_expr_tuple_0), nlj_plan.GetJoinType());
-            }
-            if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
-              return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                        nlj_plan.GetRightPlan(), std::move(right_expr_tuple_0),
-                                                        std::move(left_expr_tuple_0), nlj_plan.GetJoinType());
-            }
-          }
-        }
-      }
+  // Every conjunct must be in form of <column_expr> = <column_expr>, with one column from the left table and the other
+  // from the right table.
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjunction(nlj_plan.predicate_, &conjuncts);
+  std::vector<AbstractExpressionRef> left_key_exprs;
+  std::vector<AbstractExpressionRef> right_key_exprs;
+  for (const auto &conjunct : conjuncts) {
+    const auto *expr = dynamic_cast<const ComparisonExpression *>(conjunct.get());
+    if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+      return optimized_plan;
+    }
+    const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+    const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+    if (left_expr == nullptr || right_expr == nullptr || left_expr->GetTupleIdx() == right_expr->GetTupleIdx()) {
+      return optimized_plan;
     }
+    if (left_expr->GetTupleIdx() == 1) {
+      std::swap(left_expr, right_expr);
+    }
+    // Ensure both exprs have tuple_id == 0
+    left_key_exprs.push_back(
+        std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType()));
+    right_key_exprs.push_back(
+        std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType()));
   }
 
-  return optimized_plan;
+  auto hash_join_plan = std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
+                                                           nlj_plan.GetRightPlan(), std::move(left_key_exprs),
+                                                           std::move(right_key_exprs), nlj_plan.GetJoinType());
+
+  // Table scans are the only inputs whose size can be estimated.
+  auto estimate = [this](const AbstractPlanNodeRef &input) -> std::optional<size_t> {
+    if (input->GetType() == PlanType::SeqScan) {
+      return EstimatedCardinality(dynamic_cast<const SeqScanPlanNode &>(*input).table_name_);
+    }
+    if (input->GetType() == PlanType::MockScan) {
+      return EstimatedCardinality(dynamic_cast<const MockScanPlanNode &>(*input).GetTable());
+    }
+    return std::nullopt;
+  };
+  if (nlj_plan.GetJoinType() == JoinType::INNER) {
+    auto left_size = estimate(nlj_plan.GetLeftPlan());
+    auto right_size = estimate(nlj_plan.GetRightPlan());
+    hash_join_plan->build_left_ = left_size.has_value() && right_size.has_value() && *left_size < *right_size;
+  }
+  return hash_join_plan;
 }
 
 }  // namespace bustub
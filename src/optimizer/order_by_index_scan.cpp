@@ -17,6 +17,7 @@
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
 #include "optimizer/optimizer.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "type/type_id.h"
 
 namespace bustub {
@@ -32,25 +33,19 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
     const auto &sort_plan = dynamic_cast<const SortPlanNode &>(*optimized_plan);
     const auto &order_bys = sort_plan.GetOrderBy();
 
-    // Has exactly one order by column
-    if (order_bys.size() != 1) {
-      return optimized_plan;
-    }
-
-    // Order type is asc or default
-    const auto &[order_type, expr] = order_bys[0];
-    if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
-      return optimized_plan;
-    }
-
-    // Order expression is a column value expression
-    const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
-    if (column_value_expr == nullptr) {
-      return optimized_plan;
+    // Every order by is ascending (or default) on a plain column
+    std::vector<uint32_t> order_by_column_ids;
+    for (const auto &[order_type, expr] : order_bys) {
+      if (!(order_type == OrderByType::ASC || order_type == OrderByType::DEFAULT)) {
+        return optimized_plan;
+      }
+      const auto *column_value_expr = dynamic_cast<ColumnValueExpression *>(expr.get());
+      if (column_value_expr == nullptr) {
+        return optimized_plan;
+      }
+      order_by_column_ids.push_back(column_value_expr->GetColIdx());
     }
 
-    auto order_by_column_id = column_value_expr->GetColIdx();
-
     // Has exactly one child
     BUSTUB_ENSURE(optimized_plan->children_.size() == 1, "Sort with multiple children?? Impossible!");
     const auto &child_plan = optimized_plan->children_[0];
@@ -61,9 +56,19 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // The order by columns are a prefix of the key columns. Strings cut to a prefix in the key don't sort right.
         const auto &columns = index->key_schema_.GetColumns();
-        if (columns.size() == 1 &&
-            columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
+        if (columns.size() < order_by_column_ids.size() || IsLossyIndexKey(index->key_schema_)) {
+          continue;
+        }
+        bool matched = true;
+        for (size_t i = 0; i < order_by_column_ids.size(); i++) {
+          if (columns[i].GetName() != table_info->schema_.GetColumn(order_by_column_ids[i]).GetName()) {
+            matched = false;
+            break;
+          }
+        }
+        if (matched) {
           // Index matched, return index scan instead
           return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
         }
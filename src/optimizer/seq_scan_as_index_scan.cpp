@@ -0,0 +1,254 @@
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "catalog/column.h"
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/type_id.h"
+
+namespace bustub {
+
+namespace {
+
+/** `a < b` is `b > a`; used when the column is on the right-hand side. */
+auto FlipComparison(ComparisonType comp_type) -> ComparisonType {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/** Key range collected from the conjuncts on the indexed column. */
+struct KeyRange {
+  std::optional<Value> lower_;
+  bool lower_inclusive_{true};
+  std::optional<Value> upper_;
+  bool upper_inclusive_{true};
+
+  void TightenLower(const Value &bound, bool inclusive) {
+    if (!lower_.has_value() || bound.CompareGreaterThan(*lower_) == CmpBool::CmpTrue ||
+        (bound.CompareEquals(*lower_) == CmpBool::CmpTrue && !inclusive)) {
+      lower_ = bound;
+      lower_inclusive_ = inclusive;
+    }
+  }
+
+  void TightenUpper(const Value &bound, bool inclusive) {
+    if (!upper_.has_value() || bound.CompareLessThan(*upper_) == CmpBool::CmpTrue ||
+        (bound.CompareEquals(*upper_) == CmpBool::CmpTrue && !inclusive)) {
+      upper_ = bound;
+      upper_inclusive_ = inclusive;
+    }
+  }
+};
+
+auto IsIntegerType(TypeId type) -> bool {
+  return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+}
+
+/**
+ * Keys are encoded in the column's own type, so the constant has to be converted first. Only conversions that keep
+ * the comparison's meaning are done: integers widen or narrow when the value fits, and become decimals.
+ */
+auto CoerceToColumnType(const Value &constant, TypeId col_type) -> std::optional<Value> {
+  if (constant.GetTypeId() == col_type) {
+    return constant;
+  }
+  if (!IsIntegerType(constant.GetTypeId()) || !(IsIntegerType(col_type) || col_type == TypeId::DECIMAL)) {
+    return std::nullopt;
+  }
+  try {
+    return constant.CastAs(col_type);
+  } catch (const Exception &) {
+    return std::nullopt;
+  }
+}
+
+/**
+ * Narrow the range with `column op constant` (or `constant op column`) on the given column.
+ * @return false if the conjunct has another shape and has to stay in a filter
+ */
+auto ApplyToRange(const AbstractExpressionRef &expr, uint32_t col_idx, TypeId col_type, KeyRange *range) -> bool {
+  const auto *comp_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+  if (comp_expr == nullptr) {
+    return false;
+  }
+  auto comp_type = comp_expr->comp_type_;
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(0).get());
+  const auto *constant_expr = dynamic_cast<const ConstantValueExpression *>(comp_expr->GetChildAt(1).get());
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(1).get());
+    constant_expr = dynamic_cast<const ConstantValueExpression *>(comp_expr->GetChildAt(0).get());
+    comp_type = FlipComparison(comp_type);
+  }
+  if (column_expr == nullptr || constant_expr == nullptr || column_expr->GetColIdx() != col_idx) {
+    return false;
+  }
+  // A NULL never compares true.
+  if (constant_expr->val_.IsNull()) {
+    return false;
+  }
+  auto coerced = CoerceToColumnType(constant_expr->val_, col_type);
+  if (!coerced.has_value()) {
+    return false;
+  }
+  const Value &constant = *coerced;
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      range->TightenLower(constant, true);
+      range->TightenUpper(constant, true);
+      return true;
+    case ComparisonType::LessThan:
+      range->TightenUpper(constant, false);
+      return true;
+    case ComparisonType::LessThanOrEqual:
+      range->TightenUpper(constant, true);
+      return true;
+    case ComparisonType::GreaterThan:
+      range->TightenLower(constant, false);
+      return true;
+    case ComparisonType::GreaterThanOrEqual:
+      range->TightenLower(constant, true);
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+void Optimizer::SplitConjunction(const AbstractExpressionRef &expr, std::vector<AbstractExpressionRef> *conjuncts) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    SplitConjunction(logic_expr->GetChildAt(0), conjuncts);
+    SplitConjunction(logic_expr->GetChildAt(1), conjuncts);
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // The predicate is either merged into the seq scan or still sits in a filter right above it.
+  const SeqScanPlanNode *seq_scan = nullptr;
+  AbstractExpressionRef predicate;
+  if (optimized_plan->GetType() == PlanType::SeqScan) {
+    seq_scan = dynamic_cast<const SeqScanPlanNode *>(optimized_plan.get());
+    predicate = seq_scan->filter_predicate_;
+  } else if (optimized_plan->GetType() == PlanType::Filter) {
+    const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+    const auto &child_plan = filter_plan.GetChildPlan();
+    if (child_plan->GetType() == PlanType::SeqScan) {
+      seq_scan = dynamic_cast<const SeqScanPlanNode *>(child_plan.get());
+      if (seq_scan->filter_predicate_ == nullptr) {
+        predicate = filter_plan.GetPredicate();
+      }
+    }
+  }
+  if (seq_scan == nullptr || predicate == nullptr) {
+    return optimized_plan;
+  }
+
+  std::vector<AbstractExpressionRef> conjuncts;
+  SplitConjunction(predicate, &conjuncts);
+
+  const auto *table_info = catalog_.GetTable(seq_scan->GetTableOid());
+  for (const auto *index : catalog_.GetTableIndexes(table_info->name_)) {
+    // Equalities on leading key columns extend the bounds to the next column; the first column without one ends them.
+    std::vector<Value> lower_bound;
+    std::vector<Value> upper_bound;
+    bool lower_inclusive = true;
+    bool upper_inclusive = true;
+    std::vector<bool> consumed(conjuncts.size(), false);
+    for (const auto &key_column : index->key_schema_.GetColumns()) {
+      auto col_idx = table_info->schema_.TryGetColIdx(key_column.GetName());
+      if (!col_idx.has_value()) {
+        break;
+      }
+      KeyRange range;
+      std::vector<size_t> used;
+      for (size_t i = 0; i < conjuncts.size(); i++) {
+        if (!consumed[i] && ApplyToRange(conjuncts[i], *col_idx, key_column.GetType(), &range)) {
+          used.push_back(i);
+        }
+      }
+      for (size_t i : used) {
+        consumed[i] = true;
+      }
+      if (range.lower_.has_value() && range.upper_.has_value() && range.lower_inclusive_ && range.upper_inclusive_ &&
+          range.lower_->CompareEquals(*range.upper_) == CmpBool::CmpTrue) {
+        lower_bound.push_back(*range.lower_);
+        upper_bound.push_back(*range.upper_);
+        continue;
+      }
+      if (range.lower_.has_value()) {
+        lower_bound.push_back(*range.lower_);
+        lower_inclusive = range.lower_inclusive_;
+      }
+      if (range.upper_.has_value()) {
+        upper_bound.push_back(*range.upper_);
+        upper_inclusive = range.upper_inclusive_;
+      }
+      break;
+    }
+    if (lower_bound.empty() && upper_bound.empty()) {
+      continue;
+    }
+
+    std::vector<AbstractExpressionRef> remaining;
+    if (IsLossyIndexKey(index->key_schema_)) {
+      // Strings in the key may be cut to a prefix: the range only narrows the scan, and every comparison has to be
+      // checked again on the full values.
+      lower_inclusive = true;
+      upper_inclusive = true;
+      remaining = conjuncts;
+    } else {
+      for (size_t i = 0; i < conjuncts.size(); i++) {
+        if (!consumed[i]) {
+          remaining.push_back(conjuncts[i]);
+        }
+      }
+    }
+
+    AbstractPlanNodeRef index_scan =
+        std::make_shared<IndexScanPlanNode>(seq_scan->output_schema_, index->index_oid_, std::move(lower_bound),
+                                            lower_inclusive, std::move(upper_bound), upper_inclusive);
+    if (remaining.empty()) {
+      return index_scan;
+    }
+    AbstractExpressionRef residual = remaining[0];
+    for (size_t i = 1; i < remaining.size(); i++) {
+      residual = std::make_shared<LogicExpression>(residual, remaining[i], LogicType::And);
+    }
+    return std::make_shared<FilterPlanNode>(seq_scan->output_schema_, residual, index_scan);
+  }
+
+  return optimized_plan;
+}
+
+}  // namespace bustub
@@ -22,33 +22,153 @@ namespace bustub {
  *
  * This thread runs forever until system shutdown/StopFlushThread
  */
-void LogManager::RunFlushThread() {}
+void LogManager::RunFlushThread() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (flush_thread_ != nullptr) {
+    return;
+  }
+  stop_flush_thread_ = false;
+  enable_logging = true;
+  flush_thread_ = new std::thread([&] {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (!stop_flush_thread_) {
+      cv_.wait_for(lock, log_timeout, [&] { return stop_flush_thread_ || flush_requested_; });
+      FlushLogBuffer(&lock);
+    }
+    // Whatever was appended before the stop still goes to disk.
+    FlushLogBuffer(&lock);
+  });
+}
 
 /*
  * Stop and join the flush thread, set enable_logging = false
  */
-void LogManager::StopFlushThread() {}
+void LogManager::StopFlushThread() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (flush_thread_ == nullptr) {
+      return;
+    }
+    stop_flush_thread_ = true;
+    enable_logging = false;
+  }
+  cv_.notify_one();
+  flush_thread_->join();
+  std::scoped_lock<std::mutex> lock(latch_);
+  delete flush_thread_;
+  flush_thread_ = nullptr;
+}
+
+void LogManager::FlushLogBuffer(std::unique_lock<std::mutex> *lock) {
+  // flush_buffer_ may still be on its way to disk.
+  while (flushing_) {
+    flushed_cv_.wait(*lock);
+  }
+  flush_requested_ = false;
+  if (log_buffer_offset_ == 0) {
+    flushed_cv_.notify_all();
+    return;
+  }
+  std::swap(log_buffer_, flush_buffer_);
+  char *data = flush_buffer_;
+  const int size = log_buffer_offset_;
+  // Records are appended in LSN order under the latch, so the buffer ends with the last LSN handed out.
+  const lsn_t first_lsn = persistent_lsn_ + 1;
+  const lsn_t last_lsn = next_lsn_ - 1;
+  log_buffer_offset_ = 0;
+  flushing_ = true;
+  lock->unlock();
+  const int offset = disk_manager_->GetLogSize();
+  disk_manager_->WriteLog(data, size);
+  lock->lock();
+  flushing_ = false;
+  persistent_lsn_ = last_lsn;
+  log_writes_.emplace_back(first_lsn, offset);
+  flushed_cv_.notify_all();
+}
+
+void LogManager::Flush(lsn_t lsn) {
+  std::unique_lock<std::mutex> lock(latch_);
+  lsn = std::min<lsn_t>(lsn, next_lsn_ - 1);
+  while (persistent_lsn_ < lsn) {
+    if (flush_thread_ == nullptr || stop_flush_thread_) {
+      FlushLogBuffer(&lock);
+      continue;
+    }
+    // Whoever else is waiting right now is served by the same write.
+    flush_requested_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+}
+
+void LogManager::TruncateLog(lsn_t lsn) {
+  std::unique_lock<std::mutex> lock(latch_);
+  auto start = std::upper_bound(log_writes_.begin(), log_writes_.end(), lsn,
+                                [](lsn_t target, const std::pair<lsn_t, int> &write) { return target < write.first; });
+  // Nothing precedes the write that is still needed.
+  if (start == log_writes_.begin() || --start == log_writes_.begin()) {
+    return;
+  }
+  const auto [start_lsn, start_offset] = *start;
+  log_writes_.erase(log_writes_.begin(), start);
+  lock.unlock();
+  disk_manager_->WriteMasterRecord(start_lsn, start_offset);
+  disk_manager_->TruncateLog(start_offset);
+}
 
 /*
  * append a log record into log buffer
  * you MUST set the log record's lsn within this method
  * @return: lsn that is assigned to this log record
- *
- *
- * example below
- * // First, serialize the must have fields(20 bytes in total)
- * log_record.lsn_ = next_lsn_++;
- * memcpy(log_buffer_ + offset_, &log_record, 20);
- * int pos = offset_ + 20;
- *
- * if (log_record.log_record_type_ == LogRecordType::INSERT) {
- *    memcpy(log_buffer_ + pos, &log_record.insert_rid_, sizeof(RID));
- *    pos += sizeof(RID);
- *    // we have provided serialize function for tuple class
- *    log_record.insert_tuple_.SerializeTo(log_buffer_ + pos);
- *  }
- *
  */
-auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t { return INVALID_LSN; }
+auto LogManager::AppendLogRecord(LogRecord *log_record) -> lsn_t {
+  BUSTUB_ASSERT(log_record->size_ <= LOG_BUFFER_SIZE, "log record does not fit in the log buffer");
+  std::unique_lock<std::mutex> lock(latch_);
+  while (log_buffer_offset_ + log_record->size_ > LOG_BUFFER_SIZE) {
+    if (flush_thread_ == nullptr || stop_flush_thread_) {
+      FlushLogBuffer(&lock);
+      continue;
+    }
+    flush_requested_ = true;
+    cv_.notify_one();
+    flushed_cv_.wait(lock);
+  }
+
+  // First, serialize the must have fields (20 bytes in total).
+  log_record->lsn_ = next_lsn_++;
+  char *pos = log_buffer_ + log_buffer_offset_;
+  memcpy(pos, log_record, LogRecord::HEADER_SIZE);
+  pos += LogRecord::HEADER_SIZE;
+
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      memcpy(pos, &log_record->insert_rid_, sizeof(RID));
+      log_record->insert_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      memcpy(pos, &log_record->delete_rid_, sizeof(RID));
+      log_record->delete_tuple_.SerializeTo(pos + sizeof(RID));
+      break;
+    case LogRecordType::UPDATE:
+      memcpy(pos, &log_record->update_rid_, sizeof(RID));
+      pos += sizeof(RID);
+      log_record->old_tuple_.SerializeTo(pos);
+      pos += sizeof(int32_t) + log_record->old_tuple_.GetLength();
+      log_record->new_tuple_.SerializeTo(pos);
+      break;
+    case LogRecordType::NEWPAGE:
+      memcpy(pos, &log_record->prev_page_id_, sizeof(page_id_t));
+      memcpy(pos + sizeof(page_id_t), &log_record->page_id_, sizeof(page_id_t));
+      break;
+    default:
+      // BEGIN, COMMIT and ABORT records are just the header.
+      break;
+  }
+  log_buffer_offset_ += log_record->size_;
+  return log_record->lsn_;
+}
 
 }  // namespace bustub
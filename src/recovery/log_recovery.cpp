@@ -12,15 +12,117 @@
 
 #include "recovery/log_recovery.h"
 
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
 #include "storage/page/table_page.h"
 
 namespace bustub {
+
+/** Batches the reader may queue up for a worker before it waits, which bounds the memory redo needs. */
+static constexpr size_t MAX_PENDING_REDO_BATCHES = 4;
+
+struct LogRecovery::RedoQueue {
+  std::mutex latch_;
+  /** Signalled when a batch is queued or taken, and when the reader closes the queue. */
+  std::condition_variable cv_;
+  std::deque<std::vector<RedoTask>> batches_;
+  bool closed_{false};
+};
+
+namespace {
+
+/** Deserialize a length-prefixed tuple at *pos, advancing *pos past it, if it fits before end. */
+auto DeserializeTuple(const char *data, int *pos, int end, Tuple *tuple) -> bool {
+  if (end - *pos < static_cast<int>(sizeof(int32_t))) {
+    return false;
+  }
+  int32_t tuple_size;
+  memcpy(&tuple_size, data + *pos, sizeof(int32_t));
+  if (tuple_size < 0 || tuple_size > end - *pos - static_cast<int>(sizeof(int32_t))) {
+    return false;
+  }
+  tuple->DeserializeFrom(data + *pos);
+  *pos += sizeof(int32_t) + tuple_size;
+  return true;
+}
+
+}  // namespace
+
 /*
  * deserialize a log record from log buffer
  * @return: true means deserialize succeed, otherwise can't deserialize cause
  * incomplete log record
  */
-auto LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record) -> bool { return false; }
+auto LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record, int size) -> bool {
+  if (size < LogRecord::HEADER_SIZE) {
+    return false;
+  }
+  memcpy(&log_record->size_, data, sizeof(int32_t));
+  memcpy(&log_record->lsn_, data + 4, sizeof(lsn_t));
+  memcpy(&log_record->txn_id_, data + 8, sizeof(txn_id_t));
+  memcpy(&log_record->prev_lsn_, data + 12, sizeof(lsn_t));
+  memcpy(&log_record->log_record_type_, data + 16, sizeof(LogRecordType));
+  // A zeroed or torn tail of the log shows up as a record that is too short, too long, or of no known type.
+  if (log_record->size_ < LogRecord::HEADER_SIZE || log_record->size_ > size ||
+      log_record->log_record_type_ <= LogRecordType::INVALID || log_record->log_record_type_ > LogRecordType::NEWPAGE) {
+    return false;
+  }
+
+  const int end = log_record->size_;
+  int pos = LogRecord::HEADER_SIZE;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      if (end - pos < static_cast<int>(sizeof(RID))) {
+        return false;
+      }
+      memcpy(&log_record->insert_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      if (!DeserializeTuple(data, &pos, end, &log_record->insert_tuple_)) {
+        return false;
+      }
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      if (end - pos < static_cast<int>(sizeof(RID))) {
+        return false;
+      }
+      memcpy(&log_record->delete_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      if (!DeserializeTuple(data, &pos, end, &log_record->delete_tuple_)) {
+        return false;
+      }
+      break;
+    case LogRecordType::UPDATE:
+      if (end - pos < static_cast<int>(sizeof(RID))) {
+        return false;
+      }
+      memcpy(&log_record->update_rid_, data + pos, sizeof(RID));
+      pos += sizeof(RID);
+      if (!DeserializeTuple(data, &pos, end, &log_record->old_tuple_) ||
+          !DeserializeTuple(data, &pos, end, &log_record->new_tuple_)) {
+        return false;
+      }
+      break;
+    case LogRecordType::NEWPAGE:
+      if (end - pos < static_cast<int>(2 * sizeof(page_id_t))) {
+        return false;
+      }
+      memcpy(&log_record->prev_page_id_, data + pos, sizeof(page_id_t));
+      memcpy(&log_record->page_id_, data + pos + sizeof(page_id_t), sizeof(page_id_t));
+      pos += 2 * sizeof(page_id_t);
+      break;
+    default:
+      break;
+  }
+  return pos == end;
+}
 
 /*
  *redo phase on TABLE PAGE level(table/table_page.h)
@@ -29,12 +131,257 @@ auto LogRecovery::DeserializeLogRecord(const char *data, LogRecord *log_record)
  *LSN with log_record's sequence number, and also build active_txn_ table &
  *lsn_mapping_ table
  */
-void LogRecovery::Redo() {}
+void LogRecovery::Redo() {
+  BUSTUB_ASSERT(!enable_logging, "recovery must run before logging is enabled");
+  active_txn_.clear();
+  lsn_mapping_.clear();
+
+  std::vector<std::unique_ptr<RedoQueue>> queues;
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_redo_workers_; i++) {
+    queues.emplace_back(std::make_unique<RedoQueue>());
+    workers.emplace_back(&LogRecovery::RunRedoWorker, this, queues.back().get());
+  }
+  std::vector<std::vector<RedoTask>> batches(num_redo_workers_);
+  auto hand_over = [&]() {
+    for (size_t i = 0; i < num_redo_workers_; i++) {
+      if (batches[i].empty()) {
+        continue;
+      }
+      RedoQueue *queue = queues[i].get();
+      std::unique_lock<std::mutex> lock(queue->latch_);
+      queue->cv_.wait(lock, [&] { return queue->batches_.size() < MAX_PENDING_REDO_BATCHES; });
+      queue->batches_.emplace_back(std::move(batches[i]));
+      batches[i].clear();
+      queue->cv_.notify_all();
+    }
+  };
+
+  // The last checkpoint tells where the log that is still needed begins. A master record that does not point at the
+  // record it names belongs to some other log.
+  offset_ = 0;
+  lsn_t start_lsn;
+  int start_offset;
+  LogRecord start_record;
+  if (disk_manager_->ReadMasterRecord(&start_lsn, &start_offset) && ReadLogRecord(start_offset, &start_record) &&
+      start_record.lsn_ == start_lsn) {
+    offset_ = start_offset;
+  }
+
+  // Read the log one buffer at a time. A record that straddles the end of the buffer is read again at the start of
+  // the next one; when not even one record can be read from a fresh buffer, the log is over.
+  while (disk_manager_->ReadLog(log_buffer_, LOG_BUFFER_SIZE, offset_)) {
+    int pos = 0;
+    while (true) {
+      LogRecord log_record;
+      if (!DeserializeLogRecord(log_buffer_ + pos, &log_record, LOG_BUFFER_SIZE - pos)) {
+        break;
+      }
+      lsn_mapping_[log_record.lsn_] = offset_ + pos;
+      pos += log_record.size_;
+
+      if (log_record.log_record_type_ == LogRecordType::COMMIT || log_record.log_record_type_ == LogRecordType::ABORT) {
+        active_txn_.erase(log_record.txn_id_);
+        continue;
+      }
+      active_txn_[log_record.txn_id_] = log_record.lsn_;
+      if (log_record.log_record_type_ == LogRecordType::BEGIN) {
+        continue;
+      }
+
+      page_id_t page_id;
+      if (log_record.log_record_type_ == LogRecordType::INSERT) {
+        page_id = log_record.insert_rid_.GetPageId();
+      } else if (log_record.log_record_type_ == LogRecordType::UPDATE) {
+        page_id = log_record.update_rid_.GetPageId();
+      } else if (log_record.log_record_type_ == LogRecordType::NEWPAGE) {
+        page_id = log_record.page_id_;
+        if (log_record.prev_page_id_ != INVALID_PAGE_ID) {
+          // The previous page gets linked to the new one.
+          batches[log_record.prev_page_id_ % num_redo_workers_].emplace_back(log_record.prev_page_id_, log_record);
+        }
+      } else {
+        page_id = log_record.delete_rid_.GetPageId();
+      }
+      batches[page_id % num_redo_workers_].emplace_back(page_id, std::move(log_record));
+    }
+    hand_over();
+    if (pos == 0) {
+      break;
+    }
+    offset_ += pos;
+  }
+
+  for (auto &queue : queues) {
+    std::scoped_lock<std::mutex> lock(queue->latch_);
+    queue->closed_ = true;
+    queue->cv_.notify_all();
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void LogRecovery::RunRedoWorker(RedoQueue *queue) {
+  // Consecutive records of the same page, which are the common case, are replayed under a single pin.
+  page_id_t page_id = INVALID_PAGE_ID;
+  TablePage *page = nullptr;
+  bool is_dirty = false;
+  std::vector<RedoTask> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(queue->latch_);
+      queue->cv_.wait(lock, [&] { return queue->closed_ || !queue->batches_.empty(); });
+      if (queue->batches_.empty()) {
+        break;
+      }
+      batch = std::move(queue->batches_.front());
+      queue->batches_.pop_front();
+      queue->cv_.notify_all();
+    }
+    for (auto &[task_page_id, log_record] : batch) {
+      if (task_page_id != page_id) {
+        if (page != nullptr) {
+          buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+        }
+        page_id = task_page_id;
+        page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+        BUSTUB_ASSERT(page != nullptr, "no frame is available to redo a log record");
+        is_dirty = false;
+      }
+      // The page already contains every change up to its LSN, so older records are skipped.
+      page->WLatch();
+      if (page->GetLSN() < log_record.lsn_) {
+        RedoRecord(page, page_id, &log_record);
+        page->SetLSN(log_record.lsn_);
+        is_dirty = true;
+      }
+      page->WUnlatch();
+    }
+  }
+  if (page != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+  }
+}
+
+void LogRecovery::RedoRecord(TablePage *page, page_id_t page_id, LogRecord *log_record) {
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT: {
+      // Replaying the page's records in log order puts the tuple back into the slot it was logged with.
+      RID rid;
+      page->InsertTuple(log_record->insert_tuple_, &rid, nullptr, nullptr, nullptr);
+      BUSTUB_ASSERT(rid == log_record->insert_rid_, "redo of an insert picked a different slot");
+      break;
+    }
+    case LogRecordType::MARKDELETE:
+      page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+      break;
+    case LogRecordType::APPLYDELETE:
+      page->ApplyDelete(log_record->delete_rid_, nullptr, nullptr);
+      break;
+    case LogRecordType::ROLLBACKDELETE:
+      page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+      break;
+    case LogRecordType::UPDATE: {
+      Tuple old_tuple;
+      page->UpdateTuple(log_record->new_tuple_, &old_tuple, log_record->update_rid_, nullptr, nullptr, nullptr);
+      break;
+    }
+    case LogRecordType::NEWPAGE:
+      if (page_id == log_record->page_id_) {
+        page->Init(page_id, bustub_page_size, log_record->prev_page_id_, nullptr, nullptr);
+      } else {
+        page->SetNextPageId(log_record->page_id_);
+      }
+      break;
+    default:
+      break;
+  }
+}
 
 /*
  *undo phase on TABLE PAGE level(table/table_page.h)
  *iterate through active txn map and undo each operation
  */
-void LogRecovery::Undo() {}
+void LogRecovery::Undo() {
+  BUSTUB_ASSERT(!enable_logging, "recovery must run before logging is enabled");
+  // Undo the records of all loser transactions together, from the newest to the oldest.
+  std::priority_queue<lsn_t> to_undo;
+  for (const auto &[txn_id, last_lsn] : active_txn_) {
+    to_undo.push(last_lsn);
+  }
+  while (!to_undo.empty()) {
+    const lsn_t lsn = to_undo.top();
+    to_undo.pop();
+    auto offset = lsn_mapping_.find(lsn);
+    LogRecord log_record;
+    if (offset == lsn_mapping_.end() || !ReadLogRecord(offset->second, &log_record)) {
+      throw Exception("log record " + std::to_string(lsn) + " cannot be read for undo");
+    }
+    UndoRecord(&log_record);
+    if (log_record.prev_lsn_ != INVALID_LSN) {
+      to_undo.push(log_record.prev_lsn_);
+    }
+  }
+  active_txn_.clear();
+}
+
+void LogRecovery::UndoRecord(LogRecord *log_record) {
+  page_id_t page_id;
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      page_id = log_record->insert_rid_.GetPageId();
+      break;
+    case LogRecordType::MARKDELETE:
+    case LogRecordType::APPLYDELETE:
+    case LogRecordType::ROLLBACKDELETE:
+      page_id = log_record->delete_rid_.GetPageId();
+      break;
+    case LogRecordType::UPDATE:
+      page_id = log_record->update_rid_.GetPageId();
+      break;
+    default:
+      // Transaction records change no page, and a new page that is left empty does no harm.
+      return;
+  }
+
+  auto *page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(page != nullptr, "no frame is available to undo a log record");
+  page->WLatch();
+  switch (log_record->log_record_type_) {
+    case LogRecordType::INSERT:
+      page->ApplyDelete(log_record->insert_rid_, nullptr, nullptr);
+      break;
+    case LogRecordType::MARKDELETE:
+      page->RollbackDelete(log_record->delete_rid_, nullptr, nullptr);
+      break;
+    case LogRecordType::APPLYDELETE: {
+      RID rid;
+      page->InsertTuple(log_record->delete_tuple_, &rid, nullptr, nullptr, nullptr);
+      break;
+    }
+    case LogRecordType::ROLLBACKDELETE:
+      page->MarkDelete(log_record->delete_rid_, nullptr, nullptr, nullptr);
+      break;
+    case LogRecordType::UPDATE: {
+      Tuple new_tuple;
+      page->UpdateTuple(log_record->old_tuple_, &new_tuple, log_record->update_rid_, nullptr, nullptr, nullptr);
+      break;
+    }
+    default:
+      break;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+auto LogRecovery::ReadLogRecord(int offset, LogRecord *log_record) -> bool {
+  int32_t size;
+  if (!disk_manager_->ReadLog(reinterpret_cast<char *>(&size), sizeof(int32_t), offset) ||
+      size < LogRecord::HEADER_SIZE || size > LOG_BUFFER_SIZE) {
+    return false;
+  }
+  return disk_manager_->ReadLog(log_buffer_, size, offset) && DeserializeLogRecord(log_buffer_, log_record, size);
+}
 
 }  // namespace bustub
@@ -10,8 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
@@ -37,91 +41,103 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       return;
     }
     log_name_ = file_name_.substr(0, n) + ".log";
+    master_name_ = file_name_.substr(0, n) + ".master";
 
-    log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
-    // directory or file does not exist
-    if (!log_io_.is_open()) {
-        log_io_.clear();
-        // create a new file
-        try {
-            log_io_.open(log_name_, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-        } catch (const std::ios_base::failure &e) {
-            throw Exception(std::string("can't open dblog file: ") + e.what());
-        }
+    // the log is only ever appended to; reads use pread
+    log_fd_ = open(log_name_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);  // NOLINT
+    if (log_fd_ < 0) {
+      throw Exception(std::string("can't open dblog file: ") + std::strerror(errno));
     }
 
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    // directory or file does not exist
-    if (!db_io_.is_open()) {
-        db_io_.clear();
-        // create a new file
-        try {
-            db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-        } catch (const std::ios_base::failure &e) {
-            throw Exception(std::string("can't open db file: ") + e.what());
-        }
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);  // NOLINT
+    if (db_fd_ < 0) {
+      throw Exception(std::string("can't open db file: ") + std::strerror(errno));
+    }
+    struct stat stat_buf;
+    if (fstat(db_fd_, &stat_buf) == 0) {
+      db_file_size_ = stat_buf.st_size;
     }
 
     buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  if (log_fd_ >= 0) {
+    close(log_fd_);
+    log_fd_ = -1;
   }
-  log_io_.close();
 }
 
 /**
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * BUSTUB_PAGE_SIZE;
-  // set write cursor to offset
+  int64_t offset = static_cast<int64_t>(page_id) * bustub_page_size;
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, BUSTUB_PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
-    return;
+  size_t written = 0;
+  while (written < static_cast<size_t>(bustub_page_size)) {
+    ssize_t rc = pwrite(db_fd_, page_data + written, bustub_page_size - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+  // grow the cached file size; concurrent writers may extend it in any order
+  int64_t end = offset + bustub_page_size;
+  int64_t size = db_file_size_.load();
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * BUSTUB_PAGE_SIZE;
+  int64_t offset = static_cast<int64_t>(page_id) * bustub_page_size;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset > db_file_size_.load()) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, BUSTUB_PAGE_SIZE);
-    if (db_io_.bad()) {
+    return;
+  }
+  size_t read_count = 0;
+  while (read_count < static_cast<size_t>(bustub_page_size)) {
+    ssize_t rc = pread(db_fd_, page_data + read_count, bustub_page_size - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
       LOG_DEBUG("I/O error while reading");
       return;
     }
-    // if file ends before reading BUSTUB_PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < BUSTUB_PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+    if (rc == 0) {
+      break;
     }
+    read_count += rc;
+  }
+  // if file ends before reading bustub_page_size
+  if (read_count < static_cast<size_t>(bustub_page_size)) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, bustub_page_size - read_count);
   }
 }
 
@@ -147,15 +163,23 @@ void DiskManager::WriteLog(char *log_data, int size) {
 
   num_flushes_ += 1;
   // sequence write
-  log_io_.write(log_data, size);
-
-  // check for I/O error
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while writing log");
+  int written = 0;
+  while (written < size) {
+    ssize_t rc = write(log_fd_, log_data + written, size - written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing log");
+      return;
+    }
+    written += rc;
+  }
+  // the log is only durable once it is synced; everyone waiting on this flush shares the sync
+  if (fdatasync(log_fd_) != 0) {
+    LOG_DEBUG("I/O error while syncing log");
     return;
   }
-  // needs to flush to keep disk file in sync
-  log_io_.flush();
   flush_log_ = false;
 }
 
@@ -170,23 +194,78 @@ auto DiskManager::ReadLog(char *log_data, int size, int offset) -> bool {
     // LOG_DEBUG("file size is %d", GetFileSize(log_name_));
     return false;
   }
-  log_io_.seekp(offset);
-  log_io_.read(log_data, size);
-
-  if (log_io_.bad()) {
-    LOG_DEBUG("I/O error while reading log");
-    return false;
+  int read_count = 0;
+  while (read_count < size) {
+    ssize_t rc = pread(log_fd_, log_data + read_count, size - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading log");
+      return false;
+    }
+    if (rc == 0) {
+      break;
+    }
+    read_count += rc;
   }
   // if log file ends before reading "size"
-  int read_count = log_io_.gcount();
   if (read_count < size) {
-    log_io_.clear();
     memset(log_data + read_count, 0, size - read_count);
   }
 
   return true;
 }
 
+auto DiskManager::GetLogSize() -> int { return GetFileSize(log_name_); }
+
+/**
+ * Punch a hole into the log file rather than shrinking it, so that LSN to offset mappings stay valid
+ */
+void DiskManager::TruncateLog(int offset) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+  if (offset > 0 && fallocate(log_fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, offset) != 0) {
+    LOG_DEBUG("cannot release log space: %s", std::strerror(errno));
+  }
+#endif
+}
+
+/**
+ * Write the master record to a temporary file and rename it over the old one
+ */
+void DiskManager::WriteMasterRecord(lsn_t lsn, int offset) {
+  std::string tmp_name = master_name_ + ".tmp";
+  int fd = open(tmp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);  // NOLINT
+  if (fd < 0) {
+    LOG_DEBUG("cannot create master record: %s", std::strerror(errno));
+    return;
+  }
+  char record[sizeof(lsn_t) + sizeof(int)];
+  memcpy(record, &lsn, sizeof(lsn_t));
+  memcpy(record + sizeof(lsn_t), &offset, sizeof(int));
+  bool written = write(fd, record, sizeof(record)) == static_cast<ssize_t>(sizeof(record)) && fsync(fd) == 0;
+  close(fd);
+  if (!written || rename(tmp_name.c_str(), master_name_.c_str()) != 0) {
+    LOG_DEBUG("I/O error while writing master record");
+  }
+}
+
+auto DiskManager::ReadMasterRecord(lsn_t *lsn, int *offset) -> bool {
+  int fd = open(master_name_.c_str(), O_RDONLY);  // NOLINT
+  if (fd < 0) {
+    return false;
+  }
+  char record[sizeof(lsn_t) + sizeof(int)];
+  bool read_all = read(fd, record, sizeof(record)) == static_cast<ssize_t>(sizeof(record));
+  close(fd);
+  if (!read_all) {
+    return false;
+  }
+  memcpy(lsn, record, sizeof(lsn_t));
+  memcpy(offset, record + sizeof(lsn_t), sizeof(int));
+  return true;
+}
+
 /**
  * Returns number of flushes made so far
  */
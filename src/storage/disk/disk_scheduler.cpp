@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler.cpp
+//
+// Identification: src/storage/disk/disk_scheduler.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_scheduler.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskScheduler::DiskScheduler(DiskManager *disk_manager, size_t num_workers) : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_workers > 0, "the disk scheduler needs at least one worker");
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([&] { StartWorkerThread(); });
+  }
+}
+
+DiskScheduler::~DiskScheduler() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void DiskScheduler::Schedule(DiskRequest r) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    request_queue_.emplace_back(std::move(r));
+  }
+  cv_.notify_one();
+}
+
+void DiskScheduler::StartWorkerThread() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [&] { return stopped_ || !request_queue_.empty(); });
+    if (request_queue_.empty()) {
+      return;
+    }
+    DiskRequest r = std::move(request_queue_.front());
+    request_queue_.pop_front();
+    lock.unlock();
+
+    if (r.is_write_) {
+      disk_manager_->WritePage(r.page_id_, r.data_);
+    } else {
+      disk_manager_->ReadPage(r.page_id_, r.data_);
+    }
+    if (r.on_complete_) {
+      r.on_complete_();
+    }
+    r.callback_.set_value(true);
+  }
+}
+
+}  // namespace bustub
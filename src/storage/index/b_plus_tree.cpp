@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -10,13 +14,15 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, int key_size, int rid_offset)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      key_size_(key_size),
+      rid_offset_(rid_offset) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
@@ -58,44 +64,195 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::FindLeafPageRW(const KeyType &key, Transaction *transaction, Operation op) -> Page * {
-  if (IsEmpty()) {
-    return nullptr;
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               const KeyComparator *match) {
+  const KeyComparator &equals = match != nullptr ? *match : comparator_;
+  results->assign(keys.size(), {});
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+  // The read-latched leaf that the previous key ended in. Later keys are not smaller, so they never look back.
+  Page *page = nullptr;
+  for (size_t n = 0; n < order.size(); n++) {
+    const size_t i = order[n];
+    const KeyType &key = keys[i];
+    if (n > 0 && comparator_(keys[order[n - 1]], key) == 0) {
+      // The leaf may already be past the entries of a repeated key.
+      (*results)[i] = (*results)[order[n - 1]];
+      continue;
+    }
+    page = FindLeafPageFrom(page, key);
+    if (page == nullptr) {
+      return;
+    }
+    auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = leaf_page->KeyIndex(key, comparator_);
+    while (true) {
+      if (index == leaf_page->GetSize()) {
+        if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+          break;
+        }
+        Page *next_page = buffer_pool_manager_->FetchPage(leaf_page->GetNextPageId());
+        next_page->RLatch();
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        page = next_page;
+        leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+        index = 0;
+        continue;
+      }
+      if (equals(leaf_page->KeyAt(index), key) != 0) {
+        break;
+      }
+      (*results)[i].push_back(leaf_page->ValueAt(index++));
+    }
   }
-  latch_.lock();
-  Page *curr_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (page != nullptr) {
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
+
+/*
+ * Find the leaf for a key that is not smaller than any key looked up in leaf_page before. It is leaf_page itself if
+ * that does not end before the key, or else the leaf after it if that does not, before descending from the root.
+ * @return : the read-latched leaf, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageFrom(Page *leaf_page, const KeyType &key) -> Page * {
+  for (int hops = 0; leaf_page != nullptr; hops++) {
+    auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    const int size = leaf_node->GetSize();
+    const bool covers_key = size > 0 && comparator_(key, leaf_node->KeyAt(size - 1)) <= 0;
+    if (covers_key || leaf_node->GetNextPageId() == INVALID_PAGE_ID) {
+      return leaf_page;
+    }
+    if (hops == 1) {
+      break;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(leaf_node->GetNextPageId());
+    if (next_page == nullptr) {
+      break;
+    }
+    next_page->RLatch();
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    leaf_page = next_page;
+  }
+  if (leaf_page != nullptr) {
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  }
+  return FindLeafPageRW(key, nullptr, READ);
+}
+
+/*
+ * Fetch and latch the root page. The root id only changes while the old root
+ * is write-latched, so a page that is still the root once latched stays the root.
+ * @return : nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRootPage(Operation op) -> Page * {
   while (true) {
-    if (curr_page == nullptr) {
-      latch_.unlock();
+    page_id_t root_page_id = root_page_id_;
+    if (root_page_id == INVALID_PAGE_ID) {
       return nullptr;
     }
+    Page *page = buffer_pool_manager_->FetchPage(root_page_id);
+    if (page == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
     if (op == Operation::READ) {
-      curr_page->RLatch();
+      page->RLatch();
     } else {
-      curr_page->WLatch();
+      page->WLatch();
     }
-    if (transaction != nullptr) {
-      transaction->AddIntoPageSet(curr_page);
-    }
-    if (root_page_id_ == curr_page->GetPageId()) {
-      break;
+    if (root_page_id_ == root_page_id) {
+      return page;
     }
     if (op == Operation::READ) {
+      page->RUnlatch();
+    } else {
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+  }
+}
+
+/*
+ * Descend with read latches and write-latch only the leaf. This succeeds when
+ * the leaf is safe for op, which is the common case, and then the leaf is the
+ * only page in the transaction's page set.
+ * @return : nullptr if the caller has to fall back to FindLeafPageRW
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, Transaction *transaction, Operation op) -> Page * {
+  Page *curr_page = FetchRootPage(READ);
+  if (curr_page == nullptr) {
+    return nullptr;
+  }
+  auto curr_page_inter = reinterpret_cast<InternalPage *>(curr_page->GetData());
+  // A change to a root leaf may change the root id, which needs the write-latched root.
+  if (curr_page_inter->IsLeafPage()) {
+    curr_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
+    return nullptr;
+  }
+  while (true) {
+    Page *next_page = buffer_pool_manager_->FetchPage(curr_page_inter->Lookup(key, comparator_));
+    if (next_page == nullptr) {
+      curr_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
+      return nullptr;
+    }
+    next_page->RLatch();
+    auto next_page_inter = reinterpret_cast<InternalPage *>(next_page->GetData());
+    if (next_page_inter->IsLeafPage()) {
+      // Splitting or merging the leaf needs a write latch on its parent, so the
+      // leaf still covers key after trading the read latch for a write latch.
+      next_page->RUnlatch();
+      next_page->WLatch();
+      curr_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
+      if (!IsSafe(next_page, op)) {
+        next_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(next_page->GetPageId(), false);
+        return nullptr;
+      }
+      transaction->AddIntoPageSet(next_page);
+      return next_page;
+    }
+    curr_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
+    curr_page = next_page;
+    curr_page_inter = next_page_inter;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageRW(const KeyType &key, Transaction *transaction, Operation op) -> Page * {
+  Page *curr_page = FetchRootPage(op);
+  if (curr_page == nullptr) {
+    return nullptr;
+  }
+  if (transaction != nullptr) {
+    transaction->AddIntoPageSet(curr_page);
+  }
+  auto curr_page_inter = reinterpret_cast<InternalPage *>(curr_page->GetData());
+  while (!curr_page_inter->IsLeafPage()) {
+    Page *next_page = buffer_pool_manager_->FetchPage(curr_page_inter->Lookup(key, comparator_));
+    if (next_page == nullptr) {
+      // Every frame is pinned. Let go of the path so other threads can finish, then descend again.
       if (transaction != nullptr) {
         UnlockAndUnpin(transaction, op);
       } else {
         curr_page->RUnlatch();
         buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
       }
-    } else {
-      UnlockAndUnpin(transaction, op);
+      std::this_thread::yield();
+      return FindLeafPageRW(key, transaction, op);
     }
-    curr_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  }
-  assert(root_page_id_ == curr_page->GetPageId());
-  auto curr_page_inter = reinterpret_cast<InternalPage *>(curr_page->GetData());
-  while (!curr_page_inter->IsLeafPage()) {
-    Page *next_page = buffer_pool_manager_->FetchPage(curr_page_inter->Lookup(key, comparator_));
     if (op == Operation::READ) {
       next_page->RLatch();
       if (transaction != nullptr) {
@@ -117,7 +274,6 @@ auto BPLUSTREE_TYPE::FindLeafPageRW(const KeyType &key, Transaction *transaction
     curr_page = next_page;
     curr_page_inter = next_page_inter;
   }
-  latch_.unlock();
   return curr_page;
 }
 
@@ -164,14 +320,17 @@ auto BPLUSTREE_TYPE::UnlockAndUnpin(Transaction *transaction, Operation op) -> v
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
-  Page *page_leaf = FindLeafPageRW(key, transaction, INSERT);
+  Page *page_leaf = FindLeafPageOptimistic(key, transaction, INSERT);
+  if (page_leaf == nullptr) {
+    page_leaf = FindLeafPageRW(key, transaction, INSERT);
+  }
   while (page_leaf == nullptr) {
     latch_.lock();
     if (IsEmpty()) {
       page_id_t page_id;
       Page *page = buffer_pool_manager_->NewPage(&page_id);
       auto leaf_node = reinterpret_cast<LeafPage *>(page->GetData());
-      leaf_node->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+      leaf_node->Init(page_id, INVALID_PAGE_ID, leaf_max_size_, key_size_, rid_offset_);
       root_page_id_ = page_id;
       //UpdateRootPageId(true);
       buffer_pool_manager_->UnpinPage(page_id, true);
@@ -191,7 +350,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     page_id_t page_bother_id;
     Page *page_bother = buffer_pool_manager_->NewPage(&page_bother_id);
     auto leaf_bother_node = reinterpret_cast<LeafPage *>(page_bother->GetData());
-    leaf_bother_node->Init(page_bother_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf_bother_node->Init(page_bother_id, INVALID_PAGE_ID, leaf_max_size_, key_size_, rid_offset_);
     // 分裂，page_bother 为后半截
     leaf_node->Split(page_bother);
     // 父页需要插入一项，key = leaf_bother_node->KeyAt(0)，value = page_bother->GetPageId()
@@ -211,7 +370,7 @@ auto BPLUSTREE_TYPE::InsertInParentRW(Page *page_leaf, const KeyType &key, Page
     Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
     new_page->WLatch();
     auto new_root = reinterpret_cast<InternalPage *>(new_page->GetData());
-    new_root->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);
+    new_root->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_, key_size_);
     new_root->SetValueAt(0, page_leaf->GetPageId());
     new_root->SetKeyAt(1, key);
     new_root->SetValueAt(1, page_bother->GetPageId());
@@ -248,7 +407,7 @@ auto BPLUSTREE_TYPE::InsertInParentRW(Page *page_leaf, const KeyType &key, Page
   page_id_t page_parent_bother_id;
   Page *page_parent_bother = buffer_pool_manager_->NewPage(&page_parent_bother_id);
   auto parent_bother_node = reinterpret_cast<InternalPage *>(page_parent_bother->GetData());
-  parent_bother_node->Init(page_parent_bother_id, INVALID_PAGE_ID, internal_max_size_);
+  parent_bother_node->Init(page_parent_bother_id, INVALID_PAGE_ID, internal_max_size_, key_size_);
   parent_node->Split(key, page_bother, page_parent_bother, comparator_, buffer_pool_manager_);
   buffer_pool_manager_->UnpinPage(page_bother->GetPageId(), true);
   transaction->GetPageSet()->pop_back();
@@ -257,6 +416,130 @@ auto BPLUSTREE_TYPE::InsertInParentRW(Page *page_leaf, const KeyType &key, Page
   InsertInParentRW(parent_page, parent_bother_node->KeyAt(0), page_parent_bother, transaction);
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+namespace {
+
+/**
+ * Number of nodes to spread a level's entries over: as few as the fill allows, but not so many that any of them ends
+ * up below the minimum size. Spread evenly, no node then gets more than its capacity either.
+ */
+auto BulkLoadNodeCount(size_t num_entries, size_t per_node, size_t min_size) -> size_t {
+  const size_t num_nodes = (num_entries + per_node - 1) / per_node;
+  return std::max<size_t>(1, std::min(num_nodes, num_entries / min_size));
+}
+
+auto BulkLoadPerNode(size_t capacity, size_t min_size, double fill_factor) -> size_t {
+  const auto per_node = static_cast<size_t>(std::lround(static_cast<double>(capacity) * fill_factor));
+  return std::clamp(per_node, min_size, capacity);
+}
+
+}  // namespace
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> *entries, double fill_factor) -> bool {
+  std::scoped_lock lock(latch_);
+  if (!IsEmpty()) {
+    return false;
+  }
+  // A stable sort keeps the first of equal keys in front, which is the one Insert() would have kept.
+  std::stable_sort(entries->begin(), entries->end(),
+                   [&](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  entries->erase(std::unique(entries->begin(), entries->end(),
+                             [&](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; }),
+                 entries->end());
+  if (entries->empty()) {
+    return true;
+  }
+
+  // Leaves split once they reach their max size, so they hold one entry less; internal pages hold max size children.
+  // The minimum sizes are the ones GetMinSize() gives a non-root node.
+  const auto leaf_capacity = static_cast<size_t>(leaf_max_size_ - 1);
+  const auto leaf_min_size = std::max<size_t>(1, leaf_max_size_ / 2);
+  const auto internal_capacity = static_cast<size_t>(internal_max_size_);
+  const auto internal_min_size = static_cast<size_t>((internal_max_size_ + 1) / 2);
+  std::vector<BulkLoadLevel> levels;
+  levels.push_back({entries->size(), BulkLoadNodeCount(entries->size(),
+                                                       BulkLoadPerNode(leaf_capacity, leaf_min_size, fill_factor),
+                                                       leaf_min_size)});
+  while (levels.back().num_nodes_ > 1) {
+    const size_t num_children = levels.back().num_nodes_;
+    levels.push_back({num_children, BulkLoadNodeCount(num_children,
+                                                      BulkLoadPerNode(internal_capacity, internal_min_size, fill_factor),
+                                                      internal_min_size)});
+  }
+
+  // Each level keeps only the node it is filling pinned; a full node is done for good.
+  for (const auto &[key, value] : *entries) {
+    if (levels[0].entries_left_ == 0) {
+      BulkLoadNewNode(&levels, 0, key);
+    }
+    reinterpret_cast<LeafPage *>(levels[0].page_->GetData())->InsertLast(key, value);
+    levels[0].entries_left_--;
+  }
+  for (const auto &level : levels) {
+    buffer_pool_manager_->UnpinPage(level.page_->GetPageId(), true);
+  }
+  root_page_id_ = levels.back().page_->GetPageId();
+  return true;
+}
+
+/*
+ * Start the next node of a level and hook it into its parent, which is started first if needed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoadNewNode(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &first_key)
+    -> Page * {
+  auto &curr = (*levels)[level];
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to bulk load the b+ tree into");
+  }
+  const page_id_t parent_page_id =
+      level + 1 < levels->size() ? BulkLoadAddChild(levels, level + 1, first_key, page_id) : INVALID_PAGE_ID;
+  if (level == 0) {
+    reinterpret_cast<LeafPage *>(page->GetData())
+        ->Init(page_id, parent_page_id, leaf_max_size_, key_size_, rid_offset_);
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_page_id, internal_max_size_, key_size_);
+  }
+  if (curr.page_ != nullptr) {
+    if (level == 0) {
+      reinterpret_cast<LeafPage *>(curr.page_->GetData())->SetNextPageId(page_id);
+    }
+    buffer_pool_manager_->UnpinPage(curr.page_->GetPageId(), true);
+  }
+  // The first num_entries_ % num_nodes_ nodes take one entry more than the others.
+  curr.entries_left_ =
+      curr.num_entries_ / curr.num_nodes_ + (curr.nodes_started_ < curr.num_entries_ % curr.num_nodes_ ? 1 : 0);
+  curr.nodes_started_++;
+  curr.page_ = page;
+  return page;
+}
+
+/*
+ * Append a child to the internal page that a level is filling.
+ * @return: the page id of the parent the child went to
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoadAddChild(std::vector<BulkLoadLevel> *levels, size_t level, const KeyType &key,
+                                      page_id_t child_page_id) -> page_id_t {
+  auto &curr = (*levels)[level];
+  if (curr.entries_left_ == 0) {
+    BulkLoadNewNode(levels, level, key);
+  }
+  auto internal_node = reinterpret_cast<InternalPage *>(curr.page_->GetData());
+  // The key of the first child is never looked at.
+  const int index = internal_node->GetSize();
+  internal_node->SetKeyAt(index, key);
+  internal_node->SetValueAt(index, child_page_id);
+  internal_node->IncreaseSize(1);
+  curr.entries_left_--;
+  return curr.page_->GetPageId();
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -272,7 +555,10 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   if (IsEmpty()) {
     return;
   }
-  auto leaf_page = FindLeafPageRW(key, transaction, DELETE);
+  auto leaf_page = FindLeafPageOptimistic(key, transaction, DELETE);
+  if (leaf_page == nullptr) {
+    leaf_page = FindLeafPageRW(key, transaction, DELETE);
+  }
   if (leaf_page == nullptr) {
     return;
   }
@@ -324,10 +610,11 @@ void BPLUSTREE_TYPE::AdjustRootPageRW(Page *page, Transaction *transaction) {
   auto b_node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   if (b_node->IsLeafPage() && b_node->GetSize() == 0) {
     root_page_id_ = INVALID_PAGE_ID;
-  }
-  if (!b_node->IsLeafPage() && b_node->GetSize() == 1) {
+  } else if (!b_node->IsLeafPage() && b_node->GetSize() == 1) {
     auto inter_node = reinterpret_cast<InternalPage *>(b_node);
     root_page_id_ = inter_node->ValueAt(0);
+  } else {
+    return;
   }
   //UpdateRootPageId(false);
   transaction->AddIntoDeletedPageSet(page->GetPageId());
@@ -392,10 +679,10 @@ void BPLUSTREE_TYPE::RedistributeRW(Page *page, Page *bother_page, Page *parent_
       ValueType first_value = leaf_bother_node->ValueAt(0);
       KeyType first_key = leaf_bother_node->KeyAt(0);
       leaf_bother_node->Delete(first_key, comparator_);
+      key = leaf_bother_node->KeyAt(0);
       bother_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(leaf_bother_node->GetPageId(), true);
       leaf_b_node->InsertLast(first_key, first_value);
-      key = leaf_bother_node->KeyAt(0);
     }
     auto inter_parent_node = reinterpret_cast<InternalPage *>(parent_page->GetData());
     int index = inter_parent_node->KeyIndex(parent_key, comparator_);
@@ -412,7 +699,7 @@ void BPLUSTREE_TYPE::CoalesceRW(Page *page, Page *bother_page, const KeyType &pa
   if (b_node->IsLeafPage()) {
     auto leaf_bother_node = reinterpret_cast<LeafPage *>(bother_page->GetData());
     auto leaf_b_node = reinterpret_cast<LeafPage *>(page->GetData());
-    leaf_bother_node->Merge(page, buffer_pool_manager_);
+    leaf_bother_node->Merge(page);
     leaf_bother_node->SetNextPageId(leaf_b_node->GetNextPageId());
   } else {
     auto inter_bother_node = reinterpret_cast<InternalPage *>(bother_page->GetData());
@@ -436,11 +723,10 @@ void BPLUSTREE_TYPE::CoalesceRW(Page *page, Page *bother_page, const KeyType &pa
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
+  Page *curr_page = FetchRootPage(READ);
+  if (curr_page == nullptr) {
     return INDEXITERATOR_TYPE();
   }
-  Page *curr_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  curr_page->RLatch();
   auto curr_page_inter = reinterpret_cast<InternalPage *>(curr_page->GetData());
   while (!curr_page_inter->IsLeafPage()) {
     Page *next_page = buffer_pool_manager_->FetchPage(curr_page_inter->ValueAt(0));
@@ -456,7 +742,8 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
- * first, then construct index iterator
+ * first, then construct index iterator positioned at the first key that is not
+ * less than the input key
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -465,17 +752,25 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
     return INDEXITERATOR_TYPE();
   }
   auto leaf_page = FindLeafPageRW(key, nullptr, READ);
-  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
-  int index;
-  for (index = 0; index < leaf_node->GetSize(); index++) {
-    if (comparator_(leaf_node->KeyAt(index), key) == 0) {
-      break;
-    }
+  if (leaf_page == nullptr) {
+    return INDEXITERATOR_TYPE();
   }
+  auto leaf_node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+  int index = leaf_node->KeyIndex(key, comparator_);
   if (index == leaf_node->GetSize()) {
+    page_id_t next_page_id = leaf_node->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      // Every key is smaller; this is the position End() describes.
+      leaf_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+      return INDEXITERATOR_TYPE(nullptr, index, leaf_page->GetPageId(), buffer_pool_manager_);
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    next_page->RLatch();
     leaf_page->RUnlatch();
     buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
-    return End();
+    leaf_page = next_page;
+    index = 0;
   }
   return INDEXITERATOR_TYPE(leaf_page, index, leaf_page->GetPageId(), buffer_pool_manager_);
 }
@@ -487,11 +782,10 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  if (IsEmpty()) {
+  Page *curr_page = FetchRootPage(READ);
+  if (curr_page == nullptr) {
     return INDEXITERATOR_TYPE();
   }
-  Page *curr_page = buffer_pool_manager_->FetchPage(root_page_id_);
-  curr_page->RLatch();
   auto curr_page_inter = reinterpret_cast<InternalPage *>(curr_page->GetData());
   while (!curr_page_inter->IsLeafPage()) {
     Page *next_page = buffer_pool_manager_->FetchPage(curr_page_inter->ValueAt(curr_page_inter->GetSize() - 1));
@@ -504,9 +798,10 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   }
   auto curr_node = reinterpret_cast<LeafPage *>(curr_page->GetData());
   page_id_t page_id = curr_page->GetPageId();
+  int size = curr_node->GetSize();
   curr_page->RUnlatch();
   buffer_pool_manager_->UnpinPage(curr_page->GetPageId(), false);
-  return INDEXITERATOR_TYPE(curr_page, curr_node->GetSize(), page_id, buffer_pool_manager_);
+  return INDEXITERATOR_TYPE(nullptr, size, page_id, buffer_pool_manager_);
 }
 
 /**
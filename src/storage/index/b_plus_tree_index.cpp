@@ -11,41 +11,201 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
+namespace {
+
+/** The smallest node sizes that splits and merges work with. */
+constexpr size_t MIN_LEAF_ENTRIES = 2;
+constexpr size_t MIN_INTERNAL_ENTRIES = 3;
+
+auto KeySizeFitsPage(size_t key_size) -> bool {
+  const auto page_size = static_cast<size_t>(bustub_page_size);
+  return (page_size - LEAF_PAGE_HEADER_SIZE) / (key_size + sizeof(RID)) >= MIN_LEAF_ENTRIES &&
+         (page_size - INTERNAL_PAGE_HEADER_SIZE) / (key_size + sizeof(page_id_t)) >= MIN_INTERNAL_ENTRIES;
+}
+
+}  // namespace
+
+auto BPlusTreeIndexKeySize(const Schema &key_schema, bool is_unique, size_t included_size) -> size_t {
+  const size_t num_varchars = key_schema.GetUnlinedColumns().size();
+  // Every string needs its length prefix and keeps at least one character and its terminator.
+  const size_t min_size = key_schema.GetLength() + num_varchars * (sizeof(uint32_t) + 2) +
+                          (is_unique ? 0 : sizeof(int64_t)) + included_size;
+  size_t chosen = 0;
+  for (size_t key_size : {4, 8, 16, 32, 64}) {
+    if (key_size < min_size || !KeySizeFitsPage(key_size)) {
+      continue;
+    }
+    chosen = key_size;
+    if (num_varchars == 0) {
+      break;
+    }
+  }
+  if (chosen == 0) {
+    throw NotImplementedException(
+        fmt::format("index key ({}) is too wide for a b+ tree with {} byte pages", key_schema.ToString(), bustub_page_size));
+  }
+  return chosen;
+}
+
+auto IsLossyIndexKey(const Schema &key_schema) -> bool { return !key_schema.GetUnlinedColumns().empty(); }
+
+namespace {
+
+auto MakeEntrySchema(const IndexMetadata &metadata, bool with_included) -> Schema {
+  std::vector<Column> columns = metadata.GetKeySchema()->GetColumns();
+  if (!metadata.IsUnique()) {
+    columns.emplace_back("__rid", TypeId::BIGINT);
+  }
+  if (with_included) {
+    const auto &stored_columns = metadata.GetStoredSchema()->GetColumns();
+    columns.insert(columns.end(), stored_columns.begin() + metadata.GetIndexColumnCount(), stored_columns.end());
+  }
+  return Schema(columns);
+}
+
+/** The bytes of KeyType that MakeKey() may write to. Only strings fill the whole key, the rest stays zero. */
+template <typename KeyType>
+auto StoredKeySize(const Schema &entry_schema) -> int {
+  if (!entry_schema.GetUnlinedColumns().empty()) {
+    return sizeof(KeyType);
+  }
+  return std::min<int>(entry_schema.GetLength(), sizeof(KeyType));
+}
+
+}  // namespace
+
 /*
  * Constructor
  */
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
-      comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      entry_schema_(MakeEntrySchema(*GetMetadata(), false)),
+      stored_entry_schema_(MakeEntrySchema(*GetMetadata(), true)),
+      comparator_(&entry_schema_),
+      key_comparator_(GetMetadata()->GetKeySchema()),
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_,
+                 // The RID that makes keys of a non-unique index unique is also the value, leaves keep it only once.
+                 LEAF_PAGE_SLOTS(StoredKeySize<KeyType>(stored_entry_schema_), IsUnique() ? sizeof(ValueType) : 0),
+                 INTERNAL_PAGE_SLOTS(StoredKeySize<KeyType>(stored_entry_schema_)),
+                 StoredKeySize<KeyType>(stored_entry_schema_),
+                 IsUnique() ? -1 : static_cast<int>(GetKeySchema()->GetLength())) {
+  // Included columns go at fixed offsets after the key, which only keys without strings have.
+  BUSTUB_ASSERT(GetMetadata()->GetIncludedAttrs().empty() || stored_entry_schema_.GetUnlinedColumns().empty(),
+                "included columns need a key and included columns of fixed size");
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct insert index key
+auto BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, RID rid) const -> KeyType {
   KeyType index_key;
-  index_key.SetFromKey(key);
+  const Schema *key_schema = GetKeySchema();
+  const auto &varchar_columns = key_schema->GetUnlinedColumns();
+  if (varchar_columns.empty() || (IsUnique() && key.GetLength() <= sizeof(KeyType))) {
+    index_key.SetFromKey(key);
+    // Without strings, the key tuple is just the fixed-size slots, and the RID column comes right after them. Keys
+    // of non-unique indexes are never as narrow as the RID alone.
+    if constexpr (sizeof(KeyType) > sizeof(int64_t)) {
+      if (!IsUnique()) {
+        const int64_t rid_value = rid.Get();
+        memcpy(index_key.data_ + key_schema->GetLength(), &rid_value, sizeof(rid_value));
+      }
+    }
+    return index_key;
+  }
+  std::vector<Value> values;
+  values.reserve(entry_schema_.GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    values.push_back(key.GetValue(key_schema, i));
+  }
+  if (!IsUnique()) {
+    values.push_back(ValueFactory::GetBigIntValue(rid.Get()));
+  }
+  // Only strings make a key longer than its slot. Each gets the same share of the space left after the fixed-size
+  // columns, independent of the other values, so that cutting keeps the key order.
+  const size_t prefix_size =
+      (sizeof(KeyType) - entry_schema_.GetLength()) / varchar_columns.size() - sizeof(uint32_t);
+  for (uint32_t i : varchar_columns) {
+    if (!values[i].IsNull() && values[i].GetLength() > prefix_size) {
+      values[i] = ValueFactory::GetVarcharValue(values[i].ToString().substr(0, prefix_size - 1));
+    }
+  }
+  index_key.SetFromKey(Tuple(values, &entry_schema_));
+  return index_key;
+}
 
-  container_.Insert(index_key, rid, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::MakeEntry(const Tuple &stored, RID rid) const -> KeyType {
+  KeyType entry = MakeKey(stored, rid);
+  // All columns have a fixed size here, so the included columns directly follow the key columns in the stored tuple
+  // and the entry columns in the entry.
+  const uint32_t included_size = GetStoredSchema()->GetLength() - GetKeySchema()->GetLength();
+  if (included_size > 0) {
+    memcpy(entry.data_ + entry_schema_.GetLength(), stored.GetData() + GetKeySchema()->GetLength(), included_size);
+  }
+  return entry;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+auto BPLUSTREE_INDEX_TYPE::StoredValues(const KeyType &entry) const -> std::vector<Value> {
+  const uint32_t num_keys = GetIndexColumnCount();
+  const uint32_t num_included = GetStoredAttrs().size() - num_keys;
+  std::vector<Value> values;
+  values.reserve(num_keys + num_included);
+  for (uint32_t i = 0; i < num_keys; i++) {
+    values.push_back(entry.ToValue(&stored_entry_schema_, i));
+  }
+  // The RID of a non-unique index sits between the key and the included columns.
+  const uint32_t first_included = entry_schema_.GetColumnCount();
+  for (uint32_t i = 0; i < num_included; i++) {
+    values.push_back(entry.ToValue(&stored_entry_schema_, first_included + i));
+  }
+  return values;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(MakeEntry(key, rid), rid, transaction);
+}
 
-  container_.Remove(index_key, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(MakeKey(key, rid), transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  const KeyType index_key = MakeKey(key);
+  if (IsUnique()) {
+    container_.GetValue(index_key, result, transaction);
+    return;
+  }
+  // The entries of a key are next to each other, ordered by RID, and may span several leaves.
+  for (auto iterator = container_.Begin(index_key); !iterator.IsEnd(); ++iterator) {
+    const auto &[entry_key, rid] = *iterator;
+    if (key_comparator_(entry_key, index_key) != 0) {
+      break;
+    }
+    result->push_back(rid);
+  }
+}
 
-  container_.GetValue(index_key, result, transaction);
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  std::vector<KeyType> index_keys;
+  index_keys.reserve(keys.size());
+  for (const auto &key : keys) {
+    index_keys.push_back(MakeKey(key));
+  }
+  container_.GetValues(index_keys, results, IsUnique() ? nullptr : &key_comparator_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -54,6 +214,11 @@ auto BPLUSTREE_INDEX_TYPE::GetBeginIterator() -> INDEXITERATOR_TYPE { return con
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE { return container_.Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_INDEX_TYPE::GetBeginIterator(const Tuple &key) -> INDEXITERATOR_TYPE {
+  return container_.Begin(MakeKey(key));
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_INDEX_TYPE::GetEndIterator() -> INDEXITERATOR_TYPE { return container_.End(); }
 
@@ -17,13 +17,53 @@ INDEXITERATOR_TYPE::IndexIterator() : page_id_(INVALID_PAGE_ID) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(Page *curr_page, int index, page_id_t page_id, BufferPoolManager *bufferPoolManager)
-    : page_id_(page_id), curr_page_(curr_page), index_(index), buffer_pool_manager_(bufferPoolManager) {}
+    : page_id_(page_id),
+      curr_page_(curr_page),
+      index_(index),
+      buffer_pool_manager_(bufferPoolManager),
+      latched_(curr_page != nullptr) {}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : page_id_(other.page_id_),
+      curr_page_(other.curr_page_),
+      index_(other.index_),
+      buffer_pool_manager_(other.buffer_pool_manager_),
+      latched_(other.latched_) {
+  other.latched_ = false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+  if (this != &other) {
+    Release();
+    page_id_ = other.page_id_;
+    curr_page_ = other.curr_page_;
+    index_ = other.index_;
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    latched_ = other.latched_;
+    other.latched_ = false;
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  if (latched_) {
+    curr_page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(curr_page_->GetPageId(), false);
+    latched_ = false;
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool {
+  if (!latched_) {
+    return true;
+  }
   auto curr_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(curr_page_->GetData());
   return static_cast<bool>(index_ == curr_node->GetSize() && curr_node->GetNextPageId() == INVALID_PAGE_ID);
 }
@@ -31,7 +71,8 @@ auto INDEXITERATOR_TYPE::IsEnd() -> bool {
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
   auto curr_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(curr_page_->GetData());
-  return curr_node->GetPair(index_);
+  entry_ = curr_node->GetPair(index_);
+  return entry_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -46,10 +87,10 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
     curr_page_ = next_page;
     page_id_ = curr_page_->GetPageId();
     index_ = 0;
+    curr_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(curr_page_->GetData());
   }
   if (index_ == curr_node->GetSize() && curr_node->GetNextPageId() == INVALID_PAGE_ID) {
-    curr_page_->RUnlatch();
-    buffer_pool_manager_->UnpinPage(curr_node->GetPageId(), false);
+    Release();
   }
   return *this;
 }
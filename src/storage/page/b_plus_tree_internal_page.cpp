@@ -9,8 +9,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "common/exception.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -21,36 +23,70 @@ namespace bustub {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
- * max page size
+ * Including set page type, set current size, set page id, set parent id, set
+ * max page size and set how many bytes of each key are stored
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, int key_size) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetKeyLayout(key_size);
   SetSize(0);
 }
+
+/*
+ * Helper methods to address the packed entries
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotSize() const -> size_t { return GetKeySize() + sizeof(ValueType); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotAt(int index) -> char * { return slots_ + index * SlotSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotAt(int index) const -> const char * { return slots_ + index * SlotSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveSlots(int from, int to, int count) {
+  if (count > 0) {
+    memmove(SlotAt(to), SlotAt(from), count * SlotSize());
+  }
+}
+
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  memcpy(&key, SlotAt(index), GetKeySize());
+  memset(reinterpret_cast<char *>(&key) + GetKeySize(), 0, sizeof(KeyType) - GetKeySize());
+  return key;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  memcpy(SlotAt(index), &key, GetKeySize());
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  ValueType value;
+  memcpy(&value, SlotAt(index) + GetKeySize(), sizeof(ValueType));
+  return value;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { array_[index].second = value; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  memcpy(SlotAt(index) + GetKeySize(), &value, sizeof(ValueType));
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &keyComparator) -> ValueType {
@@ -58,28 +94,24 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCompara
   int r = GetSize();
   while (l < r) {
     int mid = (l + r) / 2;
-    if (keyComparator(array_[mid].first, key) <= 0) {
+    if (keyComparator(KeyAt(mid), key) <= 0) {
       l = mid + 1;
     } else {
       r = mid;
     }
   }
-  return array_[r - 1].second;
+  return ValueAt(r - 1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const MappingType &value, const KeyComparator &keyComparator) -> void {
-  for (int i = GetSize() - 1; i > 0; i--) {
-    if (keyComparator(array_[i].first, value.first) > 0) {
-      array_[i + 1] = array_[i];
-    } else {
-      array_[i + 1] = value;
-      IncreaseSize(1);
-      return;
-    }
+  int index = GetSize();
+  while (index > 1 && keyComparator(KeyAt(index - 1), value.first) > 0) {
+    index--;
   }
-  SetKeyAt(1, value.first);
-  SetValueAt(1, value.second);
+  MoveSlots(index, index + 1, GetSize() - index);
+  SetKeyAt(index, value.first);
+  SetValueAt(index, value.second);
   IncreaseSize(1);
 }
 
@@ -87,23 +119,20 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Split(const KeyType &key, Page *page_bother, Page *page_parent_page,
                                            const KeyComparator &keyComparator,
                                            BufferPoolManager *buffer_pool_manager_) {
-  auto *tmp = static_cast<MappingType *>(malloc(sizeof(MappingType) * (GetMaxSize() + 1)));
   // 将 key，page_bother->GetPageId() 插入，利用 tmp 来防止溢出
+  std::vector<MappingType> tmp;
+  tmp.reserve(GetMaxSize() + 1);
+  tmp.emplace_back(KeyAt(0), ValueAt(0));
   bool flag = true;
-  tmp[0] = array_[0];
   for (int i = 1; i < GetMaxSize(); i++) {
-    if (keyComparator(array_[i].first, key) < 0) {
-      tmp[i] = array_[i];
-    } else if (flag && keyComparator(array_[i].first, key) > 0) {
+    if (flag && keyComparator(KeyAt(i), key) > 0) {
       flag = false;
-      tmp[i] = std::make_pair(key, page_bother->GetPageId());
-      tmp[i + 1] = array_[i];
-    } else {
-      tmp[i + 1] = array_[i];
+      tmp.emplace_back(key, page_bother->GetPageId());
     }
+    tmp.emplace_back(KeyAt(i), ValueAt(i));
   }
   if (flag) {
-    tmp[GetMaxSize()] = std::make_pair(key, page_bother->GetPageId());
+    tmp.emplace_back(key, page_bother->GetPageId());
   }
   auto page_bother_node = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(page_bother->GetData());
   page_bother_node->SetParentPageId(GetPageId());
@@ -112,19 +141,20 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Split(const KeyType &key, Page *page_bother
   int mid = (GetMaxSize() + 1) / 2;
   auto page_parent_node = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(page_parent_page->GetData());
   for (int i = 0; i < mid; i++) {
-    array_[i] = tmp[i];
+    SetKeyAt(i, tmp[i].first);
+    SetValueAt(i, tmp[i].second);
   }
   int i = 0;
   while (mid <= (GetMaxSize())) {
     Page *child = buffer_pool_manager_->FetchPage(tmp[mid].second);
     auto child_node = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(child->GetData());
     child_node->SetParentPageId(page_parent_node->GetPageId());
-    page_parent_node->array_[i++] = tmp[mid++];
+    page_parent_node->SetKeyAt(i, tmp[mid].first);
+    page_parent_node->SetValueAt(i++, tmp[mid++].second);
     page_parent_node->IncreaseSize(1);
     IncreaseSize(-1);
     buffer_pool_manager_->UnpinPage(child->GetPageId(), true);
   }
-  free(tmp);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -133,9 +163,7 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Delete(const KeyType &key, const KeyCompara
   if (index >= GetSize() || keyComparator(KeyAt(index), key) != 0) {
     return false;
   }
-  for (int i = index + 1; i < GetSize(); i++) {
-    array_[i - 1] = array_[i];
-  }
+  MoveSlots(index + 1, index, GetSize() - index - 1);
   IncreaseSize(-1);
   return true;
 }
@@ -146,7 +174,7 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyCompa
   int r = GetSize();
   while (l < r) {
     int mid = (l + r) / 2;
-    if (keyComparator(array_[mid].first, key) < 0) {
+    if (keyComparator(KeyAt(mid), key) < 0) {
       l = mid + 1;
     } else {
       r = mid;
@@ -182,14 +210,9 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Merge(const KeyType &key, Page *right_page,
                                            BufferPoolManager *buffer_pool_manager_) -> void {
   auto right = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(right_page->GetData());
   int size = GetSize();
-  array_[GetSize()] = std::make_pair(key, right->ValueAt(0));
-  IncreaseSize(1);
-  for (int i = GetSize(), j = 1; j < right->GetSize(); i++, j++) {
-    array_[i] = std::make_pair(right->KeyAt(j), right->ValueAt(j));
-    IncreaseSize(1);
-  }
-  buffer_pool_manager_->UnpinPage(right->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(right->GetPageId());
+  memcpy(SlotAt(size), right->SlotAt(0), right->GetSize() * SlotSize());
+  SetKeyAt(size, key);
+  IncreaseSize(right->GetSize());
   for (int i = size; i < GetSize(); i++) {
     page_id_t child_page_id = ValueAt(i);
     auto child_page = buffer_pool_manager_->FetchPage(child_page_id);
@@ -201,9 +224,7 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Merge(const KeyType &key, Page *right_page,
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertFirst(const KeyType &key, const ValueType &value) -> void {
-  for (int i = GetSize(); i > 0; i--) {
-    array_[i] = array_[i - 1];
-  }
+  MoveSlots(0, 1, GetSize());
   SetValueAt(0, value);
   SetKeyAt(1, key);
   IncreaseSize(1);
@@ -211,9 +232,7 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertFirst(const KeyType &key, const Value
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::DeleteFirst() -> void {
-  for (int i = 1; i < GetSize(); i++) {
-    array_[i - 1] = array_[i];
-  }
+  MoveSlots(1, 0, GetSize() - 1);
   IncreaseSize(-1);
 }
 
@@ -9,9 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
@@ -24,15 +26,17 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next page id, set max size and set how entries are laid out
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, int key_size,
+                                      int rid_offset) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetNextPageId(INVALID_PAGE_ID);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::LEAF_PAGE);
+  SetKeyLayout(key_size, rid_offset);
   SetSize(0);
 }
 
@@ -45,26 +49,69 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return nex
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/*
+ * Helper methods to address the packed entries
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SlotSize() const -> size_t {
+  return GetKeySize() + (GetRidOffset() < 0 ? sizeof(ValueType) : 0);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SlotAt(int index) -> char * { return slots_ + index * SlotSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::SlotAt(int index) const -> const char * { return slots_ + index * SlotSize(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetAt(int index, const KeyType &key, const ValueType &value) {
+  char *slot = SlotAt(index);
+  memcpy(slot, &key, GetKeySize());
+  if (GetRidOffset() < 0) {
+    memcpy(slot + GetKeySize(), &value, sizeof(ValueType));
+  }
+  BUSTUB_ASSERT(ValueAt(index) == value, "a value kept in the key must be the RID of the key");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveSlots(int from, int to, int count) {
+  if (count > 0) {
+    memmove(SlotAt(to), SlotAt(from), count * SlotSize());
+  }
+}
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
+  KeyType key;
+  memcpy(&key, SlotAt(index), GetKeySize());
+  memset(reinterpret_cast<char *>(&key) + GetKeySize(), 0, sizeof(KeyType) - GetKeySize());
+  return key;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
+  if (GetRidOffset() >= 0) {
+    int64_t rid;
+    memcpy(&rid, SlotAt(index) + GetRidOffset(), sizeof(rid));
+    return ValueType(rid);
+  }
+  ValueType value;
+  memcpy(&value, SlotAt(index) + GetKeySize(), sizeof(ValueType));
+  return value;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(MappingType value, int index, const KeyComparator &keyComparator) -> bool {
-  if (index < GetSize() && keyComparator(value.first, array_[index].first) == 0) {
+  if (index < GetSize() && keyComparator(value.first, KeyAt(index)) == 0) {
     return false;
   }
-  for (int i = GetSize() - 1; i >= index; i--) {
-    array_[i + 1] = array_[i];
-  }
-  array_[index] = value;
+  MoveSlots(index, index + 1, GetSize() - index);
   IncreaseSize(1);
+  SetAt(index, value.first, value.second);
   return true;
 }
 
@@ -74,7 +121,7 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparato
   int r = GetSize();
   while (l < r) {
     int mid = (l + r) / 2;
-    if (keyComparator(array_[mid].first, key) < 0) {
+    if (keyComparator(KeyAt(mid), key) < 0) {
       l = mid + 1;
     } else {
       r = mid;
@@ -87,23 +134,19 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Split(Page *bother_page) -> void {
   int mid = GetSize() / 2;
   auto leaf_bother_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(bother_page->GetData());
-  for (int i = mid, j = 0; i < GetMaxSize(); i++, j++) {
-    leaf_bother_page->array_[j] = array_[i];
-    IncreaseSize(-1);
-    leaf_bother_page->IncreaseSize(1);
-  }
+  memcpy(leaf_bother_page->SlotAt(0), SlotAt(mid), (GetSize() - mid) * SlotSize());
+  leaf_bother_page->SetSize(GetSize() - mid);
+  SetSize(mid);
   leaf_bother_page->next_page_id_ = next_page_id_;
   SetNextPageId(bother_page->GetPageId());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, int index, const KeyComparator &keyComparator) -> bool {
-  if (keyComparator(array_[index].first, key) != 0) {
+  if (keyComparator(KeyAt(index), key) != 0) {
     return false;
   }
-  for (int i = index; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  MoveSlots(index + 1, index, GetSize() - index - 1);
   IncreaseSize(-1);
   return true;
 }
@@ -114,42 +157,34 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Delete(const KeyType &key, const KeyComparator
   if (index >= GetSize() || keyComparator(KeyAt(index), key) != 0) {
     return false;
   }
-  for (int i = index + 1; i < GetSize(); i++) {
-    array_[i - 1] = array_[i];
-  }
+  MoveSlots(index + 1, index, GetSize() - index - 1);
   IncreaseSize(-1);
   return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::Merge(Page *right_page, BufferPoolManager *buffer_pool_manager_) -> void {
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::Merge(Page *right_page) -> void {
   auto right = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(right_page->GetData());
-  for (int i = GetSize(), j = 0; j < right->GetSize(); j++, i++) {
-    array_[i] = std::make_pair(right->KeyAt(j), right->ValueAt(j));
-    IncreaseSize(1);
-  }
+  memcpy(SlotAt(GetSize()), right->SlotAt(0), right->GetSize() * SlotSize());
+  IncreaseSize(right->GetSize());
   right->SetSize(0);
-  buffer_pool_manager_->UnpinPage(right->GetPageId(), true);
-  buffer_pool_manager_->DeletePage(right->GetPageId());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertFirst(const KeyType &key, const ValueType &value) -> void {
-  for (int i = GetSize(); i > 0; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[0] = std::make_pair(key, value);
+  MoveSlots(0, 1, GetSize());
   IncreaseSize(1);
+  SetAt(0, key, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::InsertLast(const KeyType &key, const ValueType &value) -> void {
-  array_[GetSize()] = std::make_pair(key, value);
   IncreaseSize(1);
+  SetAt(GetSize() - 1, key, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPair(int index) -> MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetPair(int index) const -> MappingType { return {KeyAt(index), ValueAt(index)}; }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
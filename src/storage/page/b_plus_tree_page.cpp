@@ -64,4 +64,14 @@ void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
 void BPlusTreePage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 auto BPlusTreePage::GetLSN() const -> lsn_t { return lsn_; }
 
+/*
+ * Helper methods to get/set how entries are laid out, see the header format
+ */
+auto BPlusTreePage::GetKeySize() const -> int { return key_size_; }
+auto BPlusTreePage::GetRidOffset() const -> int { return rid_offset_; }
+void BPlusTreePage::SetKeyLayout(int key_size, int rid_offset) {
+  key_size_ = static_cast<uint8_t>(key_size);
+  rid_offset_ = static_cast<int8_t>(rid_offset);
+}
+
 }  // namespace bustub
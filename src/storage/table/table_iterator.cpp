@@ -22,14 +22,51 @@ TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
     : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-    auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(rid.GetPageId()));
+    auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(rid.GetPageId(), AccessType::Scan));
     BUSTUB_ENSURE(cur_page->GetTablePageId() == rid.GetPageId(), "FUCK");
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    cur_page->RLatch();
+    ReadAhead(cur_page);
+    cur_page->RUnlatch();
+    buffer_pool_manager->UnpinPage(rid.GetPageId(), false);
+    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, true, AccessType::Scan)) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
 }
 
+void TableIterator::ReadAhead(TablePage *cur_page) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  if (read_ahead_distance_ > 0) {
+    read_ahead_distance_--;
+  }
+  if (read_ahead_distance_ == 0) {
+    // Caught up with the window (or just started), so it restarts from here.
+    read_ahead_page_id_ = cur_page->GetTablePageId();
+  }
+  while (read_ahead_distance_ < TABLE_SCAN_READ_AHEAD) {
+    page_id_t next_page_id;
+    if (read_ahead_page_id_ == cur_page->GetTablePageId()) {
+      next_page_id = cur_page->GetNextPageId();
+    } else {
+      // This page was read ahead on an earlier call, so its read has normally completed by now.
+      auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(read_ahead_page_id_, AccessType::Scan));
+      if (page == nullptr) {
+        return;
+      }
+      page->RLatch();
+      next_page_id = page->GetNextPageId();
+      page->RUnlatch();
+      buffer_pool_manager->UnpinPage(read_ahead_page_id_, false);
+    }
+    if (next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    buffer_pool_manager->PrefetchPage(next_page_id);
+    read_ahead_page_id_ = next_page_id;
+    read_ahead_distance_++;
+  }
+}
+
 auto TableIterator::operator*() -> const Tuple & {
   assert(*this != table_heap_->End());
   return *tuple_;
@@ -42,7 +79,7 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId(), AccessType::Scan));
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
@@ -53,11 +90,13 @@ auto TableIterator::operator++() -> TableIterator & {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page =
+          static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId(), AccessType::Scan));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      ReadAhead(cur_page);
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -68,7 +107,7 @@ auto TableIterator::operator++() -> TableIterator & {
   if (*this != table_heap_->End()) {
     // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
     // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
+    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false, AccessType::Scan)) {
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       throw bustub::Exception("read non-existing tuple");
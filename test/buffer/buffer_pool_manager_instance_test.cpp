@@ -12,9 +12,13 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -42,19 +46,19 @@ TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
   ASSERT_NE(nullptr, page0);
   EXPECT_EQ(0, page_id_temp);
 
-  char random_binary_data[BUSTUB_PAGE_SIZE];
+  char random_binary_data[DEFAULT_BUSTUB_PAGE_SIZE];
   // Generate random binary data
   for (char &i : random_binary_data) {
     i = uniform_dist(rng);
   }
 
   // Insert terminal characters both in the middle and at end
-  random_binary_data[BUSTUB_PAGE_SIZE / 2] = '\0';
-  random_binary_data[BUSTUB_PAGE_SIZE - 1] = '\0';
+  random_binary_data[DEFAULT_BUSTUB_PAGE_SIZE / 2] = '\0';
+  random_binary_data[DEFAULT_BUSTUB_PAGE_SIZE - 1] = '\0';
 
   // Scenario: Once we have a page, we should be able to read and write content.
-  std::memcpy(page0->GetData(), random_binary_data, BUSTUB_PAGE_SIZE);
-  EXPECT_EQ(0, std::memcmp(page0->GetData(), random_binary_data, BUSTUB_PAGE_SIZE));
+  std::memcpy(page0->GetData(), random_binary_data, DEFAULT_BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(0, std::memcmp(page0->GetData(), random_binary_data, DEFAULT_BUSTUB_PAGE_SIZE));
 
   // Scenario: We should be able to create new pages until we fill up the buffer pool.
   for (size_t i = 1; i < buffer_pool_size; ++i) {
@@ -77,7 +81,7 @@ TEST(BufferPoolManagerInstanceTest, BinaryDataTest) {
   }
   // Scenario: We should be able to fetch the data we wrote a while ago.
   page0 = bpm->FetchPage(0);
-  EXPECT_EQ(0, memcmp(page0->GetData(), random_binary_data, BUSTUB_PAGE_SIZE));
+  EXPECT_EQ(0, memcmp(page0->GetData(), random_binary_data, DEFAULT_BUSTUB_PAGE_SIZE));
   EXPECT_EQ(true, bpm->UnpinPage(0, true));
 
   // Shutdown the disk manager and remove the temporary file we created.
@@ -105,7 +109,7 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   EXPECT_EQ(0, page_id_temp);
 
   // Scenario: Once we have a page, we should be able to read and write content.
-  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  snprintf(page0->GetData(), bustub_page_size, "Hello");
   EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
 
   // Scenario: We should be able to create new pages until we fill up the buffer pool.
@@ -145,4 +149,184 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Check that a buffer pool works the same way with pages larger than the default
+TEST(BufferPoolManagerInstanceTest, LargePageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 16;
+  bustub_page_size = MAX_BUSTUB_PAGE_SIZE;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: Fill more pages than the pool holds, marking the first and last byte of each one.
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    page->GetData()[0] = static_cast<char>(i);
+    page->GetData()[MAX_BUSTUB_PAGE_SIZE - 1] = static_cast<char>(i + 1);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: Every page comes back from disk in full.
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(static_cast<char>(i), page->GetData()[0]);
+    EXPECT_EQ(static_cast<char>(i + 1), page->GetData()[MAX_BUSTUB_PAGE_SIZE - 1]);
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+  bustub_page_size = DEFAULT_BUSTUB_PAGE_SIZE;
+}
+
+// NOLINTNEXTLINE
+// Check that the page cleaner writes back the pages next in line for eviction, and only those
+TEST(BufferPoolManagerInstanceTest, PageCleanerTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int low_watermark = 4;
+  const int high_watermark = 8;
+  auto saved_interval = page_cleaner_interval;
+  page_cleaner_interval = std::chrono::milliseconds(10);
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Scenario: Fill the buffer pool with dirty, unpinned pages. Pages are evicted in creation order.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), bustub_page_size, "page %zu", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+
+  // Scenario: The cleaner writes back the high_watermark pages at the eviction end, and leaves the rest alone.
+  bpm->StartPageCleaner(low_watermark, high_watermark);
+  for (int tries = 0; tries < 200 && disk_manager->GetNumWrites() < high_watermark; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopPageCleaner();
+  EXPECT_EQ(high_watermark, disk_manager->GetNumWrites());
+
+  char buf[DEFAULT_BUSTUB_PAGE_SIZE] = {0};
+  disk_manager->ReadPage(0, buf);
+  EXPECT_EQ(0, strcmp(buf, "page 0"));
+  std::memset(buf, 0, sizeof(buf));
+  disk_manager->ReadPage(buffer_pool_size - 1, buf);
+  EXPECT_EQ(0, buf[0]);
+
+  // Scenario: Evicting a cleaned page needs no write.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(high_watermark, disk_manager->GetNumWrites());
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // Scenario: The evicted page still reads back from disk.
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+  page_cleaner_interval = saved_interval;
+}
+
+/** A DiskManager that counts how many pages are read. */
+class CountingDiskManager : public DiskManager {
+ public:
+  explicit CountingDiskManager(const std::string &db_file) : DiskManager(db_file) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManager::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<int> num_reads_{0};
+};
+
+// NOLINTNEXTLINE
+// Check that scanned and read-ahead pages only recycle each other's frames, and that read-ahead saves the fetch a read
+TEST(BufferPoolManagerInstanceTest, ScanReadAheadTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_hot_pages = 4;
+  const int num_pages = 32;
+
+  auto *disk_manager = new CountingDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), bustub_page_size, "page %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: Make pages 0-3 hot with two lookups each.
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id, AccessType::Lookup));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+  }
+
+  // Scenario: Scan pages that are not resident, reading one page ahead. Every page is read from disk exactly once,
+  // and the scan keeps recycling the same frame.
+  const page_id_t scan_end = num_pages - buffer_pool_size;
+  int reads_before_scan = disk_manager->num_reads_;
+  for (page_id_t page_id = num_hot_pages; page_id < scan_end; ++page_id) {
+    auto *page = bpm->FetchPage(page_id, AccessType::Scan);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    if (page_id + 1 < scan_end) {
+      bpm->PrefetchPage(page_id + 1);
+    }
+  }
+  EXPECT_EQ(scan_end - num_hot_pages, disk_manager->num_reads_ - reads_before_scan);
+
+  // Scenario: The hot pages survived the scan.
+  int reads_before_lookups = disk_manager->num_reads_;
+  for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+    auto *page = bpm->FetchPage(page_id, AccessType::Lookup);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+  }
+  EXPECT_EQ(reads_before_lookups, disk_manager->num_reads_);
+
+  // Scenario: With the hot pages pinned and the last scanned page evicted, read-ahead finds no frame to use.
+  for (page_id_t page_id = scan_end; page_id < scan_end + 3; ++page_id) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  int reads_before_prefetch = disk_manager->num_reads_;
+  bpm->PrefetchPage(scan_end + 3);
+  EXPECT_EQ(reads_before_prefetch, disk_manager->num_reads_);
+  for (page_id_t page_id = 0; page_id < num_hot_pages; ++page_id) {
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
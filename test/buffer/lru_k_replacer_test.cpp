@@ -5,7 +5,9 @@
 #include "buffer/lru_k_replacer.h"
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
 #include <memory>
 #include <random>
 #include <set>
@@ -97,4 +99,100 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, EvictionCandidatesTest) {  // NOLINT
+  LRUKReplacer lru_replacer(8, 2);
+
+  // Frames 0-5 get one access each, frames 2 and 4 get a second one, frame 6 is pinned.
+  for (int i = 0; i <= 6; ++i) {
+    lru_replacer.RecordAccess(i);
+  }
+  lru_replacer.RecordAccess(4);
+  lru_replacer.RecordAccess(2);
+  for (int i = 0; i <= 5; ++i) {
+    lru_replacer.SetEvictable(i, true);
+  }
+
+  // Peeking does not evict anything, and returns frames in eviction order.
+  auto candidates = lru_replacer.EvictionCandidates(4);
+  ASSERT_EQ((std::vector<frame_id_t>{0, 1, 3, 5}), candidates);
+  ASSERT_EQ(6, lru_replacer.Size());
+
+  candidates = lru_replacer.EvictionCandidates(100);
+  ASSERT_EQ(6, candidates.size());
+  for (frame_id_t expected : candidates) {
+    frame_id_t frame;
+    ASSERT_TRUE(lru_replacer.Evict(&frame));
+    ASSERT_EQ(expected, frame);
+  }
+  ASSERT_TRUE(lru_replacer.EvictionCandidates(4).empty());
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {  // NOLINT
+  LRUKReplacer lru_replacer(8, 2);
+
+  // Frames 0-3 are the hot set. Frames 4-7 are read by a scan, after the hot set was last used.
+  for (int i = 0; i < 4; ++i) {
+    lru_replacer.RecordAccess(i, AccessType::Lookup);
+    lru_replacer.RecordAccess(i, AccessType::Lookup);
+  }
+  for (int i = 4; i < 8; ++i) {
+    lru_replacer.RecordAccess(i, AccessType::Scan);
+  }
+  // A scan passing over a hot frame does not count as an access.
+  lru_replacer.RecordAccess(1, AccessType::Scan);
+  // A lookup takes frame 7 out of the cold region.
+  lru_replacer.RecordAccess(7, AccessType::Lookup);
+  for (int i = 0; i < 8; ++i) {
+    lru_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: A scan-only eviction only finds the scanned frames, in LRU order.
+  frame_id_t frame;
+  ASSERT_TRUE(lru_replacer.Evict(&frame, true));
+  ASSERT_EQ(4, frame);
+  ASSERT_EQ((std::vector<frame_id_t>{5, 6, 7, 0}), lru_replacer.EvictionCandidates(4));
+
+  // Scenario: The cold region goes before frames with fewer than k accesses, which go before the hot set.
+  for (frame_id_t expected : {5, 6, 7, 0, 1, 2, 3}) {
+    ASSERT_TRUE(lru_replacer.Evict(&frame));
+    ASSERT_EQ(expected, frame);
+  }
+  ASSERT_FALSE(lru_replacer.Evict(&frame, true));
+  ASSERT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, EvictionBenchmark) {  // NOLINT
+  const size_t k = 2;
+  const size_t num_ops = 200000;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_frames : {1024, 4096, 16384, 65536}) {
+    LRUKReplacer lru_replacer(num_frames, k);
+    std::mt19937 rng(15445);
+    // Fill the replacer with a mix of frames below and at k accesses.
+    for (size_t i = 0; i < num_frames; i++) {
+      const auto frame_id = static_cast<frame_id_t>(i);
+      for (size_t j = 0; j <= rng() % k; j++) {
+        lru_replacer.RecordAccess(frame_id);
+      }
+      lru_replacer.SetEvictable(frame_id, true);
+    }
+    ASSERT_EQ(num_frames, lru_replacer.Size());
+
+    // Every round evicts a victim and brings it straight back, like a buffer pool miss does.
+    auto clock_start = std::chrono::steady_clock::now();
+    frame_id_t frame_id;
+    for (size_t i = 0; i < num_ops; i++) {
+      ASSERT_TRUE(lru_replacer.Evict(&frame_id));
+      lru_replacer.RecordAccess(frame_id);
+      lru_replacer.SetEvictable(frame_id, true);
+    }
+    auto clock_end = std::chrono::steady_clock::now();
+    ASSERT_EQ(num_frames, lru_replacer.Size());
+    auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end - clock_start);
+    std::cout << "frames: " << num_frames << ", ns per eviction: " << dur.count() / num_ops << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
 }  // namespace bustub
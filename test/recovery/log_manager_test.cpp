@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// log_manager_test.cpp
+//
+// Identification: test/recovery/log_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "recovery/log_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "concurrency/lock_manager.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+class LogManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+    saved_log_timeout_ = log_timeout;
+  }
+
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+    log_timeout = saved_log_timeout_;
+  }
+
+  std::chrono::duration<int64_t> saved_log_timeout_{};
+};
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, AppendAndFlushTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *log_manager = new LogManager(disk_manager);
+  // Only explicit flushes and a full buffer may trigger a write.
+  log_timeout = std::chrono::seconds(100);
+  log_manager->RunFlushThread();
+  ASSERT_TRUE(enable_logging);
+
+  // Scenario: A flush makes the records up to the given LSN persistent, without waiting for the timeout.
+  char tuple_data[] = "tuple data";
+  Tuple tuple;
+  std::vector<char> serialized(sizeof(int32_t) + sizeof(tuple_data));
+  auto tuple_size = static_cast<int32_t>(sizeof(tuple_data));
+  memcpy(serialized.data(), &tuple_size, sizeof(int32_t));
+  memcpy(serialized.data() + sizeof(int32_t), tuple_data, sizeof(tuple_data));
+  tuple.DeserializeFrom(serialized.data());
+
+  LogRecord begin(0, INVALID_LSN, LogRecordType::BEGIN);
+  lsn_t begin_lsn = log_manager->AppendLogRecord(&begin);
+  LogRecord insert(0, begin_lsn, LogRecordType::INSERT, RID(1, 2), tuple);
+  lsn_t insert_lsn = log_manager->AppendLogRecord(&insert);
+  LogRecord commit(0, insert_lsn, LogRecordType::COMMIT);
+  lsn_t commit_lsn = log_manager->AppendLogRecord(&commit);
+  EXPECT_EQ(0, begin_lsn);
+  EXPECT_EQ(1, insert_lsn);
+  EXPECT_EQ(2, commit_lsn);
+  EXPECT_EQ(INVALID_LSN, log_manager->GetPersistentLSN());
+
+  log_manager->Flush(commit_lsn);
+  EXPECT_EQ(commit_lsn, log_manager->GetPersistentLSN());
+  EXPECT_EQ(1, disk_manager->GetNumFlushes());
+
+  // Scenario: The records are on disk in the documented format.
+  const int log_size = begin.GetSize() + insert.GetSize() + commit.GetSize();
+  std::vector<char> log(log_size);
+  ASSERT_TRUE(disk_manager->ReadLog(log.data(), log_size, 0));
+  int32_t header[5];
+  memcpy(header, log.data() + begin.GetSize(), sizeof(header));
+  EXPECT_EQ(insert.GetSize(), header[0]);
+  EXPECT_EQ(insert_lsn, header[1]);
+  EXPECT_EQ(0, header[2]);
+  EXPECT_EQ(begin_lsn, header[3]);
+  EXPECT_EQ(static_cast<int32_t>(LogRecordType::INSERT), header[4]);
+  RID rid;
+  memcpy(&rid, log.data() + begin.GetSize() + sizeof(header), sizeof(RID));
+  EXPECT_EQ(RID(1, 2), rid);
+  Tuple logged_tuple;
+  logged_tuple.DeserializeFrom(log.data() + begin.GetSize() + sizeof(header) + sizeof(RID));
+  ASSERT_EQ(tuple.GetLength(), logged_tuple.GetLength());
+  EXPECT_EQ(0, memcmp(tuple.GetData(), logged_tuple.GetData(), tuple.GetLength()));
+  memcpy(header, log.data() + begin.GetSize() + insert.GetSize(), sizeof(header));
+  EXPECT_EQ(commit_lsn, header[1]);
+  EXPECT_EQ(static_cast<int32_t>(LogRecordType::COMMIT), header[4]);
+
+  // Scenario: Appending more than a buffer's worth of records flushes the full buffer instead of blocking forever.
+  lsn_t last_lsn = INVALID_LSN;
+  for (int i = 0; i < 2 * LOG_BUFFER_SIZE / insert.GetSize(); i++) {
+    LogRecord record(1, last_lsn, LogRecordType::INSERT, RID(1, i), tuple);
+    last_lsn = log_manager->AppendLogRecord(&record);
+  }
+  EXPECT_LT(commit_lsn, log_manager->GetPersistentLSN());
+  EXPECT_GT(last_lsn, log_manager->GetPersistentLSN());
+
+  // Scenario: Stopping the flush thread writes out what is left.
+  log_manager->StopFlushThread();
+  EXPECT_FALSE(enable_logging);
+  EXPECT_EQ(last_lsn, log_manager->GetPersistentLSN());
+
+  delete log_manager;
+  disk_manager->ShutDown();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST_F(LogManagerTest, GroupCommitBenchmark) {
+  const auto duration = std::chrono::milliseconds(500);
+  std::cout << "<<< BEGIN" << std::endl;
+  for (int num_threads : {1, 2, 4, 8, 16}) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *log_manager = new LogManager(disk_manager);
+    auto *lock_manager = new LockManager();
+    auto *txn_manager = new TransactionManager(lock_manager, log_manager);
+    log_manager->RunFlushThread();
+
+    // Every thread commits empty transactions back to back; each commit waits until its record is on disk.
+    std::atomic<bool> stop{false};
+    std::vector<size_t> commits(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([&, i] {
+        while (!stop) {
+          Transaction *txn = txn_manager->Begin();
+          lsn_t begin_lsn = txn->GetPrevLSN();
+          txn_manager->Commit(txn);
+          EXPECT_GE(log_manager->GetPersistentLSN(), txn->GetPrevLSN());
+          EXPECT_GT(txn->GetPrevLSN(), begin_lsn);
+          delete txn;
+          commits[i]++;
+        }
+      });
+    }
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    log_manager->StopFlushThread();
+
+    size_t total = 0;
+    for (size_t count : commits) {
+      total += count;
+    }
+    const int flushes = disk_manager->GetNumFlushes();
+    std::cout << "threads: " << num_threads << ", commits/sec: " << total * 1000 / duration.count()
+              << ", commits per log flush: " << static_cast<double>(total) / std::max(flushes, 1) << std::endl;
+
+    delete txn_manager;
+    delete lock_manager;
+    delete log_manager;
+    disk_manager->ShutDown();
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -38,6 +38,7 @@ class RecoveryTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.master");
   }
 
   // This function is called after every test.
@@ -45,11 +46,12 @@ class RecoveryTest : public ::testing::Test {
     LOG_INFO("Tearing down the system..");
     remove("test.db");
     remove("test.log");
+    remove("test.master");
   };
 };
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_RedoTest) {
+TEST_F(RecoveryTest, RedoTest) {
   auto *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -138,7 +140,7 @@ TEST_F(RecoveryTest, DISABLED_RedoTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_UndoTest) {
+TEST_F(RecoveryTest, UndoTest) {
   auto *bustub_instance = new BustubInstance("test.db");
 
   ASSERT_FALSE(enable_logging);
@@ -217,7 +219,81 @@ TEST_F(RecoveryTest, DISABLED_UndoTest) {
 }
 
 // NOLINTNEXTLINE
-TEST_F(RecoveryTest, DISABLED_CheckpointTest) {
+TEST_F(RecoveryTest, MultiPageRedoUndoTest) {
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Transaction *txn = bustub_instance->txn_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+
+  // Scenario: A committed transaction fills many pages, so that every redo worker gets some of them.
+  const int num_tuples = 300;
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    tuples.emplace_back(ConstructTuple(&schema));
+    ASSERT_TRUE(test_table->InsertTuple(tuples[i], &rids[i], txn));
+  }
+  bustub_instance->txn_manager_->Commit(txn);
+  delete txn;
+
+  // Scenario: A transaction that never commits deletes, updates and inserts tuples.
+  Transaction *loser = bustub_instance->txn_manager_->Begin();
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(test_table->MarkDelete(rids[i], loser));
+    ASSERT_TRUE(test_table->UpdateTuple(tuples[i], rids[num_tuples - 1 - i], loser));
+  }
+  std::vector<RID> loser_rids(20);
+  for (auto &rid : loser_rids) {
+    ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &rid, loser));
+  }
+  delete loser;
+  delete test_table;
+
+  LOG_INFO("System crash before commit");
+  delete bustub_instance;
+
+  bustub_instance = new BustubInstance("test.db");
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  log_recovery->Undo();
+  delete log_recovery;
+
+  // Every committed tuple is back with its original value, and nothing of the loser is left.
+  txn = bustub_instance->txn_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  for (int i = 0; i < num_tuples; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(test_table->GetTuple(rids[i], &tuple, txn));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).CompareEquals(tuples[i].GetValue(&schema, 1)), CmpBool::CmpTrue);
+  }
+  for (const auto &rid : loser_rids) {
+    Tuple tuple;
+    ASSERT_FALSE(test_table->GetTuple(rid, &tuple, txn));
+  }
+  int count = 0;
+  for (auto it = test_table->Begin(txn); it != test_table->End(); ++it) {
+    count++;
+  }
+  ASSERT_EQ(num_tuples, count);
+  bustub_instance->txn_manager_->Commit(txn);
+
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+}
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, CheckpointTest) {
   auto *bustub_instance = new BustubInstance("test.db");
 
   EXPECT_FALSE(enable_logging);
@@ -277,14 +353,14 @@ TEST_F(RecoveryTest, DISABLED_CheckpointTest) {
   // compare each page in the buffer pool to that page's
   // data on disk. ensure they match after the checkpoint
   bool all_pages_match = true;
-  auto *disk_data = new char[BUSTUB_PAGE_SIZE];
+  auto *disk_data = new char[bustub_page_size];
   for (size_t i = 0; i < pool_size; i++) {
     Page *page = &pages[i];
     page_id_t page_id = page->GetPageId();
 
     if (page_id != INVALID_PAGE_ID) {
       bustub_instance->disk_manager_->ReadPage(page_id, disk_data);
-      if (std::memcmp(disk_data, page->GetData(), BUSTUB_PAGE_SIZE) != 0) {
+      if (std::memcmp(disk_data, page->GetData(), bustub_page_size) != 0) {
         all_pages_match = false;
         break;
       }
@@ -320,4 +396,87 @@ TEST_F(RecoveryTest, DISABLED_CheckpointTest) {
   LOG_INFO("Shutdown System");
   delete bustub_instance;
 }
+
+// NOLINTNEXTLINE
+TEST_F(RecoveryTest, FuzzyCheckpointTest) {
+  auto *bustub_instance = new BustubInstance("test.db");
+  bustub_instance->log_manager_->RunFlushThread();
+
+  Transaction *txn = bustub_instance->txn_manager_->Begin();
+  auto *test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                                   bustub_instance->log_manager_, txn);
+  page_id_t first_page_id = test_table->GetFirstPageId();
+
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::SMALLINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  std::vector<Tuple> tuples;
+  std::vector<RID> rids;
+  auto insert_tuples = [&](Transaction *inserter, int count) {
+    for (int i = 0; i < count; i++) {
+      RID rid;
+      tuples.emplace_back(ConstructTuple(&schema));
+      ASSERT_TRUE(test_table->InsertTuple(tuples.back(), &rid, inserter));
+      rids.push_back(rid);
+    }
+  };
+  insert_tuples(txn, 100);
+  bustub_instance->txn_manager_->Commit(txn);
+  delete txn;
+
+  // Scenario: Transactions keep running while the checkpoint writes back the dirty pages.
+  bustub_instance->checkpoint_manager_->BeginCheckpoint();
+  txn = bustub_instance->txn_manager_->Begin();
+  insert_tuples(txn, 100);
+  bustub_instance->txn_manager_->Commit(txn);
+  delete txn;
+  bustub_instance->checkpoint_manager_->EndCheckpoint();
+  // A page that was still pinned while it was written keeps its older recovery LSN, so whether the first checkpoint
+  // can truncate anything depends on timing; one taken while nothing runs always can.
+  bustub_instance->checkpoint_manager_->BeginCheckpoint();
+  bustub_instance->checkpoint_manager_->EndCheckpoint();
+
+  // Scenario: The log before the checkpoint is no longer needed, and the master record says where recovery starts.
+  lsn_t start_lsn;
+  int start_offset;
+  ASSERT_TRUE(bustub_instance->disk_manager_->ReadMasterRecord(&start_lsn, &start_offset));
+  EXPECT_GT(start_offset, 0);
+  EXPECT_GT(start_lsn, 0);
+
+  // A transaction that never commits changes tuples from both before and after the checkpoint.
+  Transaction *loser = bustub_instance->txn_manager_->Begin();
+  ASSERT_TRUE(test_table->MarkDelete(rids[0], loser));
+  ASSERT_TRUE(test_table->MarkDelete(rids[150], loser));
+  RID loser_rid;
+  ASSERT_TRUE(test_table->InsertTuple(ConstructTuple(&schema), &loser_rid, loser));
+  delete loser;
+  delete test_table;
+
+  LOG_INFO("System crash before commit");
+  delete bustub_instance;
+
+  // Scenario: Recovery starting from the checkpoint restores every committed tuple and nothing of the loser.
+  bustub_instance = new BustubInstance("test.db");
+  auto *log_recovery = new LogRecovery(bustub_instance->disk_manager_, bustub_instance->buffer_pool_manager_);
+  log_recovery->Redo();
+  log_recovery->Undo();
+  delete log_recovery;
+
+  txn = bustub_instance->txn_manager_->Begin();
+  test_table = new TableHeap(bustub_instance->buffer_pool_manager_, bustub_instance->lock_manager_,
+                             bustub_instance->log_manager_, first_page_id);
+  for (size_t i = 0; i < rids.size(); i++) {
+    Tuple tuple;
+    ASSERT_TRUE(test_table->GetTuple(rids[i], &tuple, txn));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).CompareEquals(tuples[i].GetValue(&schema, 0)), CmpBool::CmpTrue);
+  }
+  Tuple tuple;
+  ASSERT_FALSE(test_table->GetTuple(loser_rid, &tuple, txn));
+  bustub_instance->txn_manager_->Commit(txn);
+
+  delete txn;
+  delete test_table;
+  delete bustub_instance;
+}
 }  // namespace bustub
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+namespace {
+
+auto MakeEntry(int64_t key) -> std::pair<GenericKey<8>, RID> {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return {index_key, RID(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key))};
+}
+
+/**
+ * Checks the node sizes and parent links below a page.
+ * @return the depth of the leaves below it, which must all be the same
+ */
+auto CheckSubtree(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_id, size_t *num_leaves) -> int {
+  auto *page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_id, page->GetParentPageId());
+  EXPECT_GE(page->GetSize(), page->GetMinSize());
+  int depth = 0;
+  if (page->IsLeafPage()) {
+    EXPECT_LT(page->GetSize(), page->GetMaxSize());
+    (*num_leaves)++;
+  } else {
+    EXPECT_LE(page->GetSize(), page->GetMaxSize());
+    auto *internal = reinterpret_cast<BulkLoadInternalPage *>(page);
+    depth = CheckSubtree(bpm, internal->ValueAt(0), page_id, num_leaves);
+    for (int i = 1; i < internal->GetSize(); i++) {
+      EXPECT_EQ(depth, CheckSubtree(bpm, internal->ValueAt(i), page_id, num_leaves));
+    }
+    depth++;
+  }
+  bpm->UnpinPage(page_id, false);
+  return depth;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  for (double fill_factor : {1.0, 0.9, 0.5, 0.0}) {
+    for (int64_t num_keys : {1, 2, 5, 37, 1000}) {
+      BulkLoadTree tree("foo_pk", bpm, comparator, 6, 5);
+      std::vector<std::pair<GenericKey<8>, RID>> entries;
+      for (int64_t key = 0; key < num_keys; key++) {
+        entries.push_back(MakeEntry(key * 2));
+      }
+      std::shuffle(entries.begin(), entries.end(), std::mt19937(num_keys));
+      // A later entry with a key seen before is dropped, like Insert() would reject it.
+      entries.push_back({MakeEntry(0).first, RID(7, 7)});
+      ASSERT_TRUE(tree.BulkLoad(&entries, fill_factor));
+
+      size_t num_leaves = 0;
+      CheckSubtree(bpm, tree.GetRootPageId(), INVALID_PAGE_ID, &num_leaves);
+      if (fill_factor == 1.0) {
+        // Leaves hold up to 5 entries.
+        EXPECT_EQ((num_keys + 4) / 5, num_leaves);
+      }
+
+      int64_t expected = 0;
+      for (auto iter = tree.Begin(); !iter.IsEnd(); ++iter) {
+        EXPECT_EQ(MakeEntry(expected).second, (*iter).second);
+        expected += 2;
+      }
+      EXPECT_EQ(num_keys * 2, expected);
+
+      // The loaded tree takes regular inserts, lookups and removes.
+      for (int64_t key = 1; key < num_keys * 2; key += 4) {
+        ASSERT_TRUE(tree.Insert(MakeEntry(key).first, MakeEntry(key).second, transaction));
+      }
+      for (int64_t key = 0; key < num_keys * 2; key += 3) {
+        tree.Remove(MakeEntry(key).first, transaction);
+      }
+      for (int64_t key = 0; key < num_keys * 2; key++) {
+        std::vector<RID> result;
+        bool present = key % 3 != 0 && (key % 2 == 0 || key % 4 == 1);
+        EXPECT_EQ(present, tree.GetValue(MakeEntry(key).first, &result)) << key;
+      }
+
+      // Only an empty tree can be bulk loaded.
+      std::vector<std::pair<GenericKey<8>, RID>> more{MakeEntry(-1)};
+      EXPECT_FALSE(tree.BulkLoad(&more));
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeTests, BulkLoadBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(BUFFER_POOL_SIZE, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  auto *transaction = new Transaction(0);
+
+  const int64_t num_keys = 50000;
+  std::vector<int64_t> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  auto start = std::chrono::steady_clock::now();
+  BulkLoadTree inserted("inserted", bpm, comparator);
+  for (int64_t key : keys) {
+    inserted.Insert(MakeEntry(key).first, MakeEntry(key).second, transaction);
+  }
+  auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  start = std::chrono::steady_clock::now();
+  BulkLoadTree loaded("loaded", bpm, comparator);
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  entries.reserve(num_keys);
+  for (int64_t key : keys) {
+    entries.push_back(MakeEntry(key));
+  }
+  ASSERT_TRUE(loaded.BulkLoad(&entries));
+  auto load_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  size_t inserted_leaves = 0;
+  size_t loaded_leaves = 0;
+  CheckSubtree(bpm, inserted.GetRootPageId(), INVALID_PAGE_ID, &inserted_leaves);
+  CheckSubtree(bpm, loaded.GetRootPageId(), INVALID_PAGE_ID, &loaded_leaves);
+  EXPECT_LT(loaded_leaves, inserted_leaves);
+
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << "Building an index on " << num_keys << " keys" << std::endl;
+  std::cout << "One insert per key: " << insert_ms.count() << " ms, " << inserted_leaves << " leaves" << std::endl;
+  std::cout << "Bulk load: " << load_ms.count() << " ms, " << loaded_leaves << " leaves" << std::endl;
+  std::cout << ">>> END" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -2,12 +2,15 @@
  * b_plus_tree_contention_test.cpp
  */
 
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
 #include <future>  // NOLINT
 #include <iostream>
+#include <random>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
@@ -154,4 +157,64 @@ TEST(BPlusTreeTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeTest, BPlusTreeLookupContentionBenchmark) {  // NOLINT
+  const int64_t num_keys = 2000;
+  const auto duration = std::chrono::milliseconds(500);
+
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(4096);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  GenericKey<8> index_key;
+  RID rid;
+  auto *transaction = new Transaction(0);
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  delete transaction;
+
+  // Every thread looks up random keys until time is up; the whole tree stays in the buffer pool.
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    std::atomic<bool> stop{false};
+    std::vector<size_t> lookups(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.emplace_back([&, i] {
+        std::mt19937_64 rng(i);
+        GenericKey<8> lookup_key;
+        std::vector<RID> result;
+        while (!stop) {
+          lookup_key.SetFromInteger(static_cast<int64_t>(rng() % num_keys));
+          result.clear();
+          EXPECT_TRUE(tree.GetValue(lookup_key, &result));
+          lookups[i]++;
+        }
+      });
+    }
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    size_t total = 0;
+    for (size_t count : lookups) {
+      total += count;
+    }
+    std::cout << "threads: " << num_threads << ", lookups/sec: " << total * 1000 / duration.count() << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,268 @@
+/**
+ * b_plus_tree_index_test.cpp
+ */
+
+#include "storage/index/b_plus_tree_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Builds a BPlusTreeIndex over all columns of the given schema, with the key width CREATE INDEX would pick. */
+template <size_t KeySize>
+class IndexFixture {
+ public:
+  explicit IndexFixture(const Schema &table_schema, bool is_unique = true) : table_schema_(table_schema) {
+    disk_manager_ = std::make_unique<DiskManager>("test.db");
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(50, disk_manager_.get());
+    page_id_t page_id;
+    bpm_->NewPage(&page_id);
+    std::vector<uint32_t> key_attrs;
+    for (uint32_t i = 0; i < table_schema.GetColumnCount(); i++) {
+      key_attrs.push_back(i);
+    }
+    auto metadata = std::make_unique<IndexMetadata>("index", "table", &table_schema_, key_attrs, is_unique);
+    EXPECT_EQ(KeySize, BPlusTreeIndexKeySize(*metadata->GetKeySchema(), is_unique));
+    index_ = std::make_unique<BPlusTreeIndexForKeySize<KeySize>>(std::move(metadata), bpm_.get());
+  }
+
+  ~IndexFixture() {
+    index_.reset();
+    bpm_->UnpinPage(HEADER_PAGE_ID, true);
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("test.db");
+    remove("test.log");
+  }
+
+  void Insert(const std::vector<Value> &values, RID rid) {
+    index_->InsertEntry(Tuple(values, index_->GetKeySchema()), rid, &txn_);
+  }
+
+  void Delete(const std::vector<Value> &values, RID rid) {
+    index_->DeleteEntry(Tuple(values, index_->GetKeySchema()), rid, &txn_);
+  }
+
+  auto Scan(const std::vector<Value> &values) -> std::vector<RID> {
+    std::vector<RID> result;
+    index_->ScanKey(Tuple(values, index_->GetKeySchema()), &result, &txn_);
+    return result;
+  }
+
+  auto ScanMany(const std::vector<std::vector<Value>> &values) -> std::vector<std::vector<RID>> {
+    std::vector<Tuple> keys;
+    for (const auto &key_values : values) {
+      keys.emplace_back(key_values, index_->GetKeySchema());
+    }
+    std::vector<std::vector<RID>> results;
+    index_->ScanKeys(keys, &results, &txn_);
+    return results;
+  }
+
+  /** @return the max size of the root page, a leaf until the first split */
+  auto RootMaxSize() -> int {
+    page_id_t root_page_id = index_->GetBPlusTree().GetRootPageId();
+    auto *root = reinterpret_cast<BPlusTreePage *>(bpm_->FetchPage(root_page_id)->GetData());
+    int max_size = root->GetMaxSize();
+    bpm_->UnpinPage(root_page_id, false);
+    return max_size;
+  }
+
+  /** @return the slot numbers of all entries from the first key not less than values on, in key order */
+  auto SlotsFrom(const std::vector<Value> &values) -> std::vector<uint32_t> {
+    std::vector<uint32_t> slots;
+    for (auto iterator = index_->GetBeginIterator(Tuple(values, index_->GetKeySchema())); !iterator.IsEnd();
+         ++iterator) {
+      slots.push_back((*iterator).second.GetSlotNum());
+    }
+    return slots;
+  }
+
+ private:
+  Schema table_schema_;
+  Transaction txn_{0};
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<BPlusTreeIndexForKeySize<KeySize>> index_;
+};
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, KeySizeFollowsSchema) {
+  EXPECT_EQ(4, BPlusTreeIndexKeySize(*ParseCreateStatement("a int")));
+  EXPECT_EQ(8, BPlusTreeIndexKeySize(*ParseCreateStatement("a int,b int")));
+  EXPECT_EQ(8, BPlusTreeIndexKeySize(*ParseCreateStatement("a double")));
+  EXPECT_EQ(16, BPlusTreeIndexKeySize(*ParseCreateStatement("a bigint,b int")));
+  EXPECT_EQ(32, BPlusTreeIndexKeySize(*ParseCreateStatement("a int,b varchar(64)")));
+  // A non-unique index also keeps the RID in the key.
+  EXPECT_EQ(16, BPlusTreeIndexKeySize(*ParseCreateStatement("a int"), false));
+  EXPECT_EQ(16, BPlusTreeIndexKeySize(*ParseCreateStatement("a bigint"), false));
+  EXPECT_FALSE(IsLossyIndexKey(*ParseCreateStatement("a bigint,b int")));
+  EXPECT_TRUE(IsLossyIndexKey(*ParseCreateStatement("a varchar(8)")));
+  // Too wide for nodes of a few entries on the default page size.
+  EXPECT_THROW(BPlusTreeIndexKeySize(*ParseCreateStatement("a bigint,b bigint,c bigint,d bigint,e int")),
+               NotImplementedException);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, BigintAndDecimalKeys) {
+  {
+    IndexFixture<8> index(*ParseCreateStatement("a bigint"));
+    const std::vector<int64_t> keys = {5000000000, -3, 42, 1LL << 40, 0, -(1LL << 35), 7};
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      index.Insert({ValueFactory::GetBigIntValue(keys[i])}, RID(0, i));
+    }
+    EXPECT_EQ(std::vector<RID>{RID(0, 0)}, index.Scan({ValueFactory::GetBigIntValue(5000000000)}));
+    EXPECT_TRUE(index.Scan({ValueFactory::GetBigIntValue(5000000001)}).empty());
+    EXPECT_EQ((std::vector<uint32_t>{4, 6, 2, 0, 3}), index.SlotsFrom({ValueFactory::GetBigIntValue(0)}));
+  }
+  {
+    IndexFixture<8> index(*ParseCreateStatement("a double"));
+    const std::vector<double> keys = {2.5, -1.25, 100.0, 0.5, 3.0};
+    for (uint32_t i = 0; i < keys.size(); i++) {
+      index.Insert({ValueFactory::GetDecimalValue(keys[i])}, RID(0, i));
+    }
+    EXPECT_EQ(std::vector<RID>{RID(0, 3)}, index.Scan({ValueFactory::GetDecimalValue(0.5)}));
+    EXPECT_EQ((std::vector<uint32_t>{0, 4, 2}), index.SlotsFrom({ValueFactory::GetDecimalValue(1.0)}));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, CompositeKeys) {
+  IndexFixture<16> index(*ParseCreateStatement("a bigint,b int"));
+  uint32_t slot = 0;
+  for (int64_t a : {3, 1, 2}) {
+    for (int32_t b : {20, 10, 30}) {
+      index.Insert({ValueFactory::GetBigIntValue(a), ValueFactory::GetIntegerValue(b)}, RID(0, slot++));
+    }
+  }
+  EXPECT_EQ(std::vector<RID>{RID(0, 8)},
+            index.Scan({ValueFactory::GetBigIntValue(2), ValueFactory::GetIntegerValue(30)}));
+  // Seeking with the smallest value of the second column starts at the first key with that first column.
+  EXPECT_EQ((std::vector<uint32_t>{7, 6, 8, 1, 0, 2}),
+            index.SlotsFrom({ValueFactory::GetBigIntValue(2), Type::GetMinValue(TypeId::INTEGER)}));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, VarcharKeysKeepAPrefix) {
+  IndexFixture<32> index(*ParseCreateStatement("a varchar(64)"));
+  const std::vector<std::string> keys = {"counterrevolutionary", "banana", "counter", "counterintelligence", "cherry"};
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    index.Insert({ValueFactory::GetVarcharValue(keys[i])}, RID(0, i));
+  }
+  EXPECT_EQ(std::vector<RID>{RID(0, 2)}, index.Scan({ValueFactory::GetVarcharValue("counter")}));
+  EXPECT_EQ(std::vector<RID>{RID(0, 0)}, index.Scan({ValueFactory::GetVarcharValue("counterrevolutionary")}));
+  // Only the first 15 characters are in the key, so a different string with the same prefix finds the same entry.
+  EXPECT_EQ(std::vector<RID>{RID(0, 0)}, index.Scan({ValueFactory::GetVarcharValue("counterrevolutionaries")}));
+  EXPECT_EQ((std::vector<uint32_t>{4, 2, 3, 0}), index.SlotsFrom({ValueFactory::GetVarcharValue("c")}));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, NonUniqueKeys) {
+  IndexFixture<16> index(*ParseCreateStatement("a int"), false);
+  // Enough entries per key that they span several leaves.
+  for (uint32_t slot = 0; slot < 60; slot++) {
+    index.Insert({ValueFactory::GetIntegerValue(static_cast<int32_t>(slot % 3))}, RID(slot % 2, slot));
+  }
+  std::vector<RID> expected;
+  for (uint32_t slot = 1; slot < 60; slot += 3) {
+    expected.emplace_back(slot % 2, slot);
+  }
+  // Entries of a key are ordered by RID.
+  std::sort(expected.begin(), expected.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+  EXPECT_EQ(expected, index.Scan({ValueFactory::GetIntegerValue(1)}));
+  EXPECT_TRUE(index.Scan({ValueFactory::GetIntegerValue(3)}).empty());
+
+  // Deleting removes only the entry with the given RID.
+  index.Delete({ValueFactory::GetIntegerValue(1)}, RID(0, 4));
+  index.Delete({ValueFactory::GetIntegerValue(1)}, RID(1, 31));
+  index.Delete({ValueFactory::GetIntegerValue(1)}, RID(0, 5));
+  expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                [](const RID &rid) { return rid == RID(0, 4) || rid == RID(1, 31); }),
+                 expected.end());
+  EXPECT_EQ(expected, index.Scan({ValueFactory::GetIntegerValue(1)}));
+  EXPECT_EQ(20, index.Scan({ValueFactory::GetIntegerValue(2)}).size());
+  EXPECT_EQ(60 - 2, index.SlotsFrom({ValueFactory::GetIntegerValue(0)}).size());
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, NonUniqueVarcharKeysKeepStringsWithTheSamePrefix) {
+  IndexFixture<32> index(*ParseCreateStatement("a varchar(64)"), false);
+  index.Insert({ValueFactory::GetVarcharValue("counterrevolutionary")}, RID(0, 0));
+  index.Insert({ValueFactory::GetVarcharValue("counterintelligence")}, RID(0, 1));
+  index.Insert({ValueFactory::GetVarcharValue("banana")}, RID(0, 2));
+  // Both strings share the prefix that is kept, so both are candidates and callers tell them apart.
+  EXPECT_EQ((std::vector<RID>{RID(0, 0), RID(0, 1)}),
+            index.Scan({ValueFactory::GetVarcharValue("counterrevolutionary")}));
+  EXPECT_EQ(std::vector<RID>{RID(0, 2)}, index.Scan({ValueFactory::GetVarcharValue("banana")}));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, PagesStoreOnlyTheUsedKeyBytes) {
+  // An INTEGER and the RID take 12 of the 16 key bytes. Leaves keep the RID only in the key, not again as the value.
+  IndexFixture<16> non_unique(*ParseCreateStatement("a int"), false);
+  non_unique.Insert({ValueFactory::GetIntegerValue(0)}, RID(0, 0));
+  EXPECT_EQ((bustub_page_size - LEAF_PAGE_HEADER_SIZE) / 12, non_unique.RootMaxSize());
+  for (uint32_t slot = 1; slot < 200; slot++) {
+    non_unique.Insert({ValueFactory::GetIntegerValue(static_cast<int32_t>(slot % 7))}, RID(slot, slot));
+  }
+  EXPECT_EQ((bustub_page_size - INTERNAL_PAGE_HEADER_SIZE) / (12 + sizeof(page_id_t)), non_unique.RootMaxSize());
+  std::vector<RID> expected;
+  for (uint32_t slot = 3; slot < 200; slot += 7) {
+    expected.emplace_back(slot, slot);
+  }
+  EXPECT_EQ(expected, non_unique.Scan({ValueFactory::GetIntegerValue(3)}));
+
+  IndexFixture<16> unique(*ParseCreateStatement("a int,b int,c int"));
+  const std::vector<Value> key{ValueFactory::GetIntegerValue(1), ValueFactory::GetIntegerValue(2),
+                               ValueFactory::GetIntegerValue(3)};
+  unique.Insert(key, RID(4, 5));
+  EXPECT_EQ((bustub_page_size - LEAF_PAGE_HEADER_SIZE) / (12 + sizeof(RID)), unique.RootMaxSize());
+  EXPECT_EQ(std::vector<RID>{RID(4, 5)}, unique.Scan(key));
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIndexTest, ScanKeysFindsTheSameAsScanKey) {
+  // Unsorted, with repeated keys, keys far apart and close together, and keys without entries before, between and
+  // after the stored ones.
+  std::vector<std::vector<Value>> keys;
+  for (int32_t key : {598, 3, 0, 40, 42, 44, 1000, 42, -5, 98, 100, 250, 2, 597}) {
+    keys.push_back({ValueFactory::GetIntegerValue(key)});
+  }
+  auto scan_one_by_one = [&](auto *index) {
+    std::vector<std::vector<RID>> results;
+    for (const auto &key : keys) {
+      results.push_back(index->Scan(key));
+    }
+    return results;
+  };
+
+  // The fixtures share the database file, so only one is alive at a time.
+  {
+    IndexFixture<4> unique(*ParseCreateStatement("a int"));
+    for (uint32_t slot = 0; slot < 300; slot++) {
+      unique.Insert({ValueFactory::GetIntegerValue(static_cast<int32_t>(slot * 2))}, RID(slot, slot));
+    }
+    EXPECT_EQ(scan_one_by_one(&unique), unique.ScanMany(keys));
+    EXPECT_TRUE(unique.ScanMany({}).empty());
+  }
+  {
+    IndexFixture<16> non_unique(*ParseCreateStatement("a int"), false);
+    for (uint32_t slot = 0; slot < 300; slot++) {
+      non_unique.Insert({ValueFactory::GetIntegerValue(static_cast<int32_t>(slot % 50 * 2))}, RID(slot, slot));
+    }
+    EXPECT_EQ(scan_one_by_one(&non_unique), non_unique.ScanMany(keys));
+    EXPECT_EQ(6, non_unique.ScanMany(keys)[4].size());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_scheduler_test.cpp
+//
+// Identification: test/storage/disk_scheduler_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_scheduler.h"
+
+namespace bustub {
+
+class DiskSchedulerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(DiskSchedulerTest, ScheduleWriteReadPageTest) {
+  char buf[DEFAULT_BUSTUB_PAGE_SIZE] = {0};
+  char data[DEFAULT_BUSTUB_PAGE_SIZE] = {0};
+
+  auto dm = std::make_unique<DiskManager>("test.db");
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  auto promise1 = disk_scheduler->CreatePromise();
+  auto future1 = promise1.get_future();
+  disk_scheduler->Schedule({true, data, 0, std::move(promise1)});
+  ASSERT_TRUE(future1.get());
+
+  auto promise2 = disk_scheduler->CreatePromise();
+  auto future2 = promise2.get_future();
+  disk_scheduler->Schedule({false, buf, 0, std::move(promise2)});
+  ASSERT_TRUE(future2.get());
+  ASSERT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  disk_scheduler = nullptr;  // Call the DiskScheduler destructor to finish all scheduled jobs.
+  dm->ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskSchedulerTest, ManyOutstandingRequestsTest) {
+  const int num_pages = 64;
+  auto dm = std::make_unique<DiskManager>("test.db");
+  auto disk_scheduler = std::make_unique<DiskScheduler>(dm.get());
+
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(DEFAULT_BUSTUB_PAGE_SIZE));
+  std::vector<std::future<bool>> futures;
+  for (int i = 0; i < num_pages; i++) {
+    snprintf(pages[i].data(), pages[i].size(), "page %d", i);
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    disk_scheduler->Schedule({true, pages[i].data(), i, std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+
+  // Read every page back in reverse order, all requests in flight at once.
+  std::vector<std::vector<char>> bufs(num_pages, std::vector<char>(DEFAULT_BUSTUB_PAGE_SIZE));
+  futures.clear();
+  for (int i = num_pages - 1; i >= 0; i--) {
+    auto promise = disk_scheduler->CreatePromise();
+    futures.push_back(promise.get_future());
+    disk_scheduler->Schedule({false, bufs[i].data(), i, std::move(promise)});
+  }
+  for (auto &future : futures) {
+    ASSERT_TRUE(future.get());
+  }
+  for (int i = 0; i < num_pages; i++) {
+    EXPECT_EQ(pages[i], bufs[i]);
+  }
+
+  disk_scheduler = nullptr;
+  dm->ShutDown();
+}
+
+}  // namespace bustub
@@ -0,0 +1,115 @@
+/**
+ * generic_key_test.cpp
+ */
+
+#include "storage/index/generic_key.h"
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Compare two keys column by column through Value, the way every key used to be compared. */
+template <size_t KeySize>
+auto CompareThroughValues(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs, Schema *key_schema) -> int {
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value lhs_value = lhs.ToValue(key_schema, i);
+    Value rhs_value = rhs.ToValue(key_schema, i);
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/** Build keys with small random values, so that equal columns and NULLs show up often. */
+template <size_t KeySize>
+auto MakeRandomKeys(Schema *key_schema, size_t num_keys, std::mt19937 *rng) -> std::vector<GenericKey<KeySize>> {
+  std::vector<GenericKey<KeySize>> keys(num_keys);
+  for (auto &key : keys) {
+    std::vector<Value> values;
+    for (const auto &col : key_schema->GetColumns()) {
+      const int32_t raw = static_cast<int32_t>((*rng)() % 21) - 10;
+      if (raw == 10) {
+        values.push_back(ValueFactory::GetNullValueByType(col.GetType()));
+      } else if (col.GetType() == TypeId::DECIMAL) {
+        values.push_back(ValueFactory::GetDecimalValue(raw / 4.0));
+      } else if (col.GetType() == TypeId::BIGINT) {
+        values.push_back(ValueFactory::GetBigIntValue(static_cast<int64_t>(raw) << 40));
+      } else {
+        values.emplace_back(col.GetType(), raw);
+      }
+    }
+    key.SetFromKey(Tuple(values, key_schema));
+  }
+  return keys;
+}
+
+template <size_t KeySize>
+void CheckComparator(const std::string &create_stmt) {
+  auto key_schema = ParseCreateStatement(create_stmt);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  std::mt19937 rng(15445);
+  auto keys = MakeRandomKeys<KeySize>(key_schema.get(), 200, &rng);
+  for (const auto &lhs : keys) {
+    for (const auto &rhs : keys) {
+      ASSERT_EQ(CompareThroughValues(lhs, rhs, key_schema.get()), comparator(lhs, rhs)) << create_stmt;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, ComparatorMatchesValueComparison) {
+  CheckComparator<4>("a int");
+  CheckComparator<8>("a bigint");
+  CheckComparator<8>("a smallint,b int");
+  CheckComparator<16>("a tinyint,b bigint,c int");
+  // Not all integers, compared through Value.
+  CheckComparator<16>("a int,b double");
+}
+
+// NOLINTNEXTLINE
+TEST(GenericKeyTest, ComparatorBenchmark) {
+  const size_t num_keys = 1000;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (const std::string create_stmt : {"a int", "a bigint", "a int,b int"}) {
+    auto key_schema = ParseCreateStatement(create_stmt);
+    GenericComparator<8> comparator(key_schema.get());
+    std::mt19937 rng(15445);
+    auto keys = MakeRandomKeys<8>(key_schema.get(), num_keys, &rng);
+
+    int64_t sum = 0;
+    auto clock_start = std::chrono::steady_clock::now();
+    for (const auto &lhs : keys) {
+      for (const auto &rhs : keys) {
+        sum += CompareThroughValues(lhs, rhs, key_schema.get());
+      }
+    }
+    auto value_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clock_start);
+    clock_start = std::chrono::steady_clock::now();
+    for (const auto &lhs : keys) {
+      for (const auto &rhs : keys) {
+        sum -= comparator(lhs, rhs);
+      }
+    }
+    auto specialized_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clock_start);
+    ASSERT_EQ(0, sum);
+    std::cout << "key: (" << create_stmt
+              << "), ns per compare through Value: " << value_ns.count() / (num_keys * num_keys)
+              << ", specialized: " << specialized_ns.count() / (num_keys * num_keys) << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
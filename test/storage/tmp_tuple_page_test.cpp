@@ -19,18 +19,14 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
-  page.Init(page_id, BUSTUB_PAGE_SIZE);
+  page.Init(page_id, bustub_page_size);
 
   char *data = page.GetData();
   ASSERT_EQ(*reinterpret_cast<page_id_t *>(data), page_id);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), bustub_page_size);
 
   std::vector<Column> columns;
   columns.emplace_back("A", TypeId::INTEGER);
@@ -43,9 +39,52 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
   page.Insert(tuple, &tmp_tuple);
 
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 8), 4);
-  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), bustub_page_size - 8);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + bustub_page_size - 8), 4);
+  ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + bustub_page_size - 4), 123);
+  ASSERT_EQ(tmp_tuple.GetPageId(), page_id);
+  ASSERT_EQ(tmp_tuple.GetOffset(), bustub_page_size - 8);
+
+  Tuple read;
+  ASSERT_EQ(page.Get(tmp_tuple.GetOffset(), &read), bustub_page_size);
+  ASSERT_EQ(read.GetValue(&schema, 0).GetAs<int32_t>(), 123);
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, FillAndReadBack) {
+  TmpTuplePage page{};
+  page.Init(1, bustub_page_size);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema(columns);
+
+  // Tuples are inserted until the page is full.
+  int inserted = 0;
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  while (true) {
+    Tuple tuple({ValueFactory::GetIntegerValue(inserted), ValueFactory::GetVarcharValue("tmp")}, &schema);
+    if (!page.Insert(tuple, &tmp_tuple)) {
+      break;
+    }
+    inserted++;
+  }
+  ASSERT_GT(inserted, 0);
+  ASSERT_EQ(page.GetFreeSpacePointer(), tmp_tuple.GetOffset());
+
+  // Reading from the free space pointer to the end of the page yields them newest first.
+  size_t offset = page.GetFreeSpacePointer();
+  int read = 0;
+  while (offset < static_cast<size_t>(bustub_page_size)) {
+    Tuple tuple;
+    offset = page.Get(offset, &tuple);
+    read++;
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), inserted - read);
+    ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), "tmp");
+  }
+  ASSERT_EQ(offset, bustub_page_size);
+  ASSERT_EQ(read, inserted);
 }
 
 }  // namespace bustub
@@ -10,6 +10,7 @@
 #include <vector>
 #include <algorithm>
 
+#include "argparse/argparse.hpp"
 #include "myapi/api_manager.h"
 
 #define SOCKET_PATH "/tmp/bustub_core_socket"
@@ -26,9 +27,11 @@
 
 static std::unique_ptr<bustub::BustubInstance> kBustubInstance = nullptr;
 
-void BustubInit() {
+// The tracer UI wants the tiny default pages so that a table spans many of them;
+// loading real data wants large pages and a large pool instead.
+void BustubInit(int page_size, size_t buffer_pool_size) {
     std::cout << "Initialize BusTub..." << std::endl;
-    auto bustub = std::make_unique<bustub::BustubInstance>("/tmp/bustub.db");
+    auto bustub = std::make_unique<bustub::BustubInstance>("/tmp/bustub.db", 1, page_size, buffer_pool_size);
     bustub->GenerateTestTable();
 
     kBustubInstance = std::move(bustub);
@@ -62,11 +65,29 @@ void exitServer(int server_fd) {
     exit(0);
 }
 
-int main() {
+int main(int argc, char **argv) {
+
+    argparse::ArgumentParser program("socket_server");
+    program.add_argument("--page-size")
+        .help("size of a data page in bytes")
+        .default_value(bustub::DEFAULT_BUSTUB_PAGE_SIZE)
+        .action([](const std::string &value) { return std::stoi(value); });
+    program.add_argument("--buffer-pool-size")
+        .help("number of frames in the buffer pool")
+        .default_value(static_cast<size_t>(bustub::BUFFER_POOL_SIZE))
+        .action([](const std::string &value) { return static_cast<size_t>(std::stoul(value)); });
+
+    try {
+        program.parse_args(argc, argv);
+    } catch (const std::runtime_error &err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        return 1;
+    }
 
     pid_t parent_pid = getppid();
 
-    BustubInit();
+    BustubInit(program.get<int>("--page-size"), program.get<size_t>("--buffer-pool-size"));
 
     int server_fd;
     int client_fd;
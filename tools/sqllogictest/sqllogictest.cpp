@@ -73,6 +73,11 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("IndexScan not found\n");
           return false;
         }
+      } else if (opt == "ensure:index_only_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "index_only=true")) {
+          fmt::print("index-only IndexScan not found\n");
+          return false;
+        }
       } else if (opt == "ensure:topn") {
         if (!bustub::StringUtil::Contains(result.str(), "TopN")) {
           fmt::print("TopN not found\n");
@@ -83,6 +88,11 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("TopN should appear exactly twice\n");
           return false;
         }
+      } else if (opt == "ensure:hash_join") {
+        if (!bustub::StringUtil::Contains(result.str(), "HashJoin")) {
+          fmt::print("HashJoin not found\n");
+          return false;
+        }
       } else if (opt == "ensure:index_join") {
         if (!bustub::StringUtil::Contains(result.str(), "NestedIndexJoin")) {
           fmt::print("NestedIndexJoin not found\n");